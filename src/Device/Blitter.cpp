@@ -19,10 +19,15 @@
 #include "System/CPUID.hpp"
 #include "System/Debug.hpp"
 #include "System/Half.hpp"
+#include "System/Math.hpp"
 #include "System/Memory.hpp"
 #include "Vulkan/VkImage.hpp"
 #include "Vulkan/VkImageView.hpp"
 
+#include "marl/defer.h"
+#include "marl/scheduler.h"
+#include "marl/waitgroup.h"
+
 #include <utility>
 
 #if defined(__i386__) || defined(__x86_64__)
@@ -164,7 +169,7 @@ void Blitter::clear(const void *pixel, vk::Format format, vk::Image *dest, const
 			}
 		}
 	}
-	dest->contentsChanged(subresourceRange);
+	dest->contentsChanged(subresourceRange, vk::Image::DIRECT_MEMORY_ACCESS, renderArea);
 }
 
 bool Blitter::fastClear(const void *clearValue, vk::Format clearFormat, vk::Image *dest, const vk::Format &viewFormat, const VkImageSubresourceRange &subresourceRange, const VkRect2D *renderArea)
@@ -319,7 +324,7 @@ bool Blitter::fastClear(const void *clearValue, vk::Format clearFormat, vk::Imag
 			}
 		}
 	}
-	dest->contentsChanged(subresourceRange);
+	dest->contentsChanged(subresourceRange, vk::Image::DIRECT_MEMORY_ACCESS, renderArea);
 
 	return true;
 }
@@ -1817,6 +1822,48 @@ Blitter::CornerUpdateRoutineType Blitter::getCornerUpdateRoutine(const State &st
 	return cornerUpdateRoutine;
 }
 
+// Rows of a layer processed by one task, and the maximum number of tasks per layer.
+// Smaller tasks don't amortize their scheduling overhead.
+static constexpr int MinRowsPerTask = 16;
+static constexpr int MaxTasksPerLayer = 16;
+
+// Calls function(layer, y0, y1) for bands of the rows [y0, y1) of layerCount layers.
+// The bands get processed by worker threads when a scheduler is bound to the caller.
+template<typename Function>
+static void forEachRowBand(uint32_t layerCount, int y0, int y1, const Function &function)
+{
+	const int rows = y1 - y0;
+	const int bands = clamp(rows / MinRowsPerTask, 1, MaxTasksPerLayer);
+
+	if(!marl::Scheduler::get() || (layerCount * bands == 1))
+	{
+		for(uint32_t layer = 0; layer < layerCount; layer++)
+		{
+			function(layer, y0, y1);
+		}
+
+		return;
+	}
+
+	marl::WaitGroup wg(layerCount * bands);
+
+	for(uint32_t layer = 0; layer < layerCount; layer++)
+	{
+		for(int band = 0; band < bands; band++)
+		{
+			int bandY0 = y0 + (rows * band) / bands;
+			int bandY1 = y0 + (rows * (band + 1)) / bands;
+
+			marl::schedule([wg, layer, bandY0, bandY1, &function] {
+				defer(wg.done());
+				function(layer, bandY0, bandY1);
+			});
+		}
+	}
+
+	wg.wait();
+}
+
 void Blitter::blit(const vk::Image *src, vk::Image *dst, VkImageBlit2KHR region, VkFilter filter)
 {
 	ASSERT(src->getFormat() != VK_FORMAT_UNDEFINED);
@@ -1934,20 +1981,26 @@ void Blitter::blit(const vk::Image *src, vk::Image *dst, VkImageBlit2KHR region,
 		region.dstSubresource.layerCount
 	};
 
-	uint32_t lastLayer = src->getLastLayerIndex(dstSubresRange);
+	uint32_t layerCount = src->getLastLayerIndex(dstSubresRange) - dstSubresRange.baseArrayLayer + 1;
 
-	for(; dstSubres.arrayLayer <= lastLayer; srcSubres.arrayLayer++, dstSubres.arrayLayer++)
-	{
-		data.source = src->getTexelPointer({ 0, 0, 0 }, srcSubres);
-		data.dest = dst->getTexelPointer({ 0, 0, 0 }, dstSubres);
+	forEachRowBand(layerCount, data.y0d, data.y1d, [&](uint32_t layer, int y0d, int y1d) {
+		BlitData bandData = data;
+		bandData.source = src->getTexelPointer({ 0, 0, 0 }, { srcSubres.aspectMask, srcSubres.mipLevel, srcSubres.arrayLayer + layer });
+		bandData.dest = dst->getTexelPointer({ 0, 0, 0 }, { dstSubres.aspectMask, dstSubres.mipLevel, dstSubres.arrayLayer + layer });
+		bandData.y0d = y0d;
+		bandData.y1d = y1d;
 
-		ASSERT(data.source < src->end());
-		ASSERT(data.dest < dst->end());
+		ASSERT(bandData.source < src->end());
+		ASSERT(bandData.dest < dst->end());
 
-		blitRoutine(&data);
-	}
+		blitRoutine(&bandData);
+	});
 
-	dst->contentsChanged(dstSubresRange);
+	VkRect2D dstRect = {
+		{ region.dstOffsets[0].x, region.dstOffsets[0].y },
+		{ static_cast<uint32_t>(region.dstOffsets[1].x - region.dstOffsets[0].x), static_cast<uint32_t>(region.dstOffsets[1].y - region.dstOffsets[0].y) }
+	};
+	dst->contentsChanged(dstSubresRange, vk::Image::DIRECT_MEMORY_ACCESS, &dstRect);
 }
 
 static void resolveDepth(const vk::ImageView *src, vk::ImageView *dst, const VkResolveModeFlagBits depthResolveMode)
@@ -2076,41 +2129,80 @@ static inline uint32_t averageByte4(uint32_t x, uint32_t y)
 	return (x & y) + (((x ^ y) >> 1) & 0x7F7F7F7F) + ((x ^ y) & 0x01010101);
 }
 
-bool Blitter::fastResolve(const vk::Image *src, vk::Image *dst, VkImageResolve2KHR region)
+// Resolves a row of four samples per byte, as the average of pairwise averages.
+static void resolveBytes4(uint8_t *dest, const uint8_t *source, int sampleSliceB, int bytes)
 {
-	if(region.dstOffset != VkOffset3D{ 0, 0, 0 })
+	const uint8_t *source0 = source;
+	const uint8_t *source1 = source0 + sampleSliceB;
+	const uint8_t *source2 = source1 + sampleSliceB;
+	const uint8_t *source3 = source2 + sampleSliceB;
+
+	int i = 0;
+
+#if defined(__i386__) || defined(__x86_64__)
+	if(CPUID::supportsSSE2())
 	{
-		return false;
+		for(; (i + 15) < bytes; i += 16)
+		{
+			__m128i c0 = _mm_loadu_si128((const __m128i *)(source0 + i));
+			__m128i c1 = _mm_loadu_si128((const __m128i *)(source1 + i));
+			__m128i c2 = _mm_loadu_si128((const __m128i *)(source2 + i));
+			__m128i c3 = _mm_loadu_si128((const __m128i *)(source3 + i));
+
+			c0 = _mm_avg_epu8(c0, c1);
+			c2 = _mm_avg_epu8(c2, c3);
+			c0 = _mm_avg_epu8(c0, c2);
+
+			_mm_storeu_si128((__m128i *)(dest + i), c0);
+		}
 	}
+#endif
 
-	if(region.srcOffset != VkOffset3D{ 0, 0, 0 })
+	for(; (i + 3) < bytes; i += 4)
 	{
-		return false;
+		uint32_t c0 = *(const uint32_t *)(source0 + i);
+		uint32_t c1 = *(const uint32_t *)(source1 + i);
+		uint32_t c2 = *(const uint32_t *)(source2 + i);
+		uint32_t c3 = *(const uint32_t *)(source3 + i);
+
+		uint32_t c01 = averageByte4(c0, c1);
+		uint32_t c23 = averageByte4(c2, c3);
+		uint32_t c03 = averageByte4(c01, c23);
+
+		*(uint32_t *)(dest + i) = c03;
 	}
 
-	if(region.srcSubresource.layerCount != 1)
+	for(; i < bytes; i++)
 	{
-		return false;
+		uint8_t c01 = (source0[i] + source1[i] + 1) >> 1;
+		uint8_t c23 = (source2[i] + source3[i] + 1) >> 1;
+
+		dest[i] = (c01 + c23 + 1) >> 1;
 	}
+}
 
-	if(region.extent != src->getExtent() ||
-	   region.extent != dst->getExtent() ||
-	   region.extent.depth != 1)
+bool Blitter::fastResolve(const vk::Image *src, vk::Image *dst, VkImageResolve2KHR region)
+{
+	auto format = src->getFormat();
+
+	// Formats with 8-bit normalized channels resolve by averaging each byte,
+	// regardless of the number and order of the channels.
+	switch(format)
 	{
+	case VK_FORMAT_R8_UNORM:
+	case VK_FORMAT_R8G8_UNORM:
+	case VK_FORMAT_R8G8B8A8_UNORM:
+	case VK_FORMAT_B8G8R8A8_UNORM:
+	case VK_FORMAT_A8B8G8R8_UNORM_PACK32:
+		break;
+	default:
 		return false;
 	}
 
-	VkImageSubresource srcSubresource = {
-		region.srcSubresource.aspectMask,
-		region.srcSubresource.mipLevel,
-		region.srcSubresource.baseArrayLayer
-	};
-
-	VkImageSubresource dstSubresource = {
-		region.dstSubresource.aspectMask,
-		region.dstSubresource.mipLevel,
-		region.dstSubresource.baseArrayLayer
-	};
+	if(src->getSampleCount() != 4 || region.extent.depth != 1)
+	{
+		return false;
+	}
 
 	VkImageSubresourceRange dstSubresourceRange = {
 		region.dstSubresource.aspectMask,
@@ -2120,86 +2212,45 @@ bool Blitter::fastResolve(const vk::Image *src, vk::Image *dst, VkImageResolve2K
 		region.dstSubresource.layerCount
 	};
 
-	void *source = src->getTexelPointer({ 0, 0, 0 }, srcSubresource);
-	uint8_t *dest = reinterpret_cast<uint8_t *>(dst->getTexelPointer({ 0, 0, 0 }, dstSubresource));
-
-	auto format = src->getFormat();
-	auto samples = src->getSampleCount();
-	auto extent = src->getExtent();
-
-	int width = extent.width;
-	int height = extent.height;
-	int pitch = src->rowPitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, region.srcSubresource.mipLevel);
-	int slice = src->slicePitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, region.srcSubresource.mipLevel);
+	uint32_t layerCount = src->getLastLayerIndex(dstSubresourceRange) - dstSubresourceRange.baseArrayLayer + 1;
+	int rowBytes = static_cast<int>(region.extent.width * format.bytes());
+	int srcPitchB = src->rowPitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, region.srcSubresource.mipLevel);
+	int dstPitchB = dst->rowPitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, region.dstSubresource.mipLevel);
+	int sampleSliceB = src->slicePitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, region.srcSubresource.mipLevel);
+
+	forEachRowBand(layerCount, 0, region.extent.height, [&](uint32_t layer, int y0, int y1) {
+		VkImageSubresource srcSubresource = {
+			region.srcSubresource.aspectMask,
+			region.srcSubresource.mipLevel,
+			region.srcSubresource.baseArrayLayer + layer
+		};
 
-	uint8_t *source0 = (uint8_t *)source;
-	uint8_t *source1 = source0 + slice;
-	uint8_t *source2 = source1 + slice;
-	uint8_t *source3 = source2 + slice;
+		VkImageSubresource dstSubresource = {
+			region.dstSubresource.aspectMask,
+			region.dstSubresource.mipLevel,
+			region.dstSubresource.baseArrayLayer + layer
+		};
 
-	[[maybe_unused]] const bool SSE2 = CPUID::supportsSSE2();
+		const uint8_t *source = reinterpret_cast<const uint8_t *>(src->getTexelPointer({ region.srcOffset.x, region.srcOffset.y + y0, region.srcOffset.z }, srcSubresource));
+		uint8_t *dest = reinterpret_cast<uint8_t *>(dst->getTexelPointer({ region.dstOffset.x, region.dstOffset.y + y0, region.dstOffset.z }, dstSubresource));
 
-	if(format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_A8B8G8R8_UNORM_PACK32)
-	{
-		if(samples == 4)
+		for(int y = y0; y < y1; y++)
 		{
-			for(int y = 0; y < height; y++)
-			{
-				int x = 0;
-
-#if defined(__i386__) || defined(__x86_64__)
-				if(SSE2)
-				{
-					for(; (x + 3) < width; x += 4)
-					{
-						__m128i c0 = _mm_loadu_si128((__m128i *)(source0 + 4 * x));
-						__m128i c1 = _mm_loadu_si128((__m128i *)(source1 + 4 * x));
-						__m128i c2 = _mm_loadu_si128((__m128i *)(source2 + 4 * x));
-						__m128i c3 = _mm_loadu_si128((__m128i *)(source3 + 4 * x));
-
-						c0 = _mm_avg_epu8(c0, c1);
-						c2 = _mm_avg_epu8(c2, c3);
-						c0 = _mm_avg_epu8(c0, c2);
-
-						_mm_storeu_si128((__m128i *)(dest + 4 * x), c0);
-					}
-				}
-#endif
-
-				for(; x < width; x++)
-				{
-					uint32_t c0 = *(uint32_t *)(source0 + 4 * x);
-					uint32_t c1 = *(uint32_t *)(source1 + 4 * x);
-					uint32_t c2 = *(uint32_t *)(source2 + 4 * x);
-					uint32_t c3 = *(uint32_t *)(source3 + 4 * x);
+			ASSERT(source + 3 * sampleSliceB + rowBytes <= src->end());
+			ASSERT(dest + rowBytes <= dst->end());
 
-					uint32_t c01 = averageByte4(c0, c1);
-					uint32_t c23 = averageByte4(c2, c3);
-					uint32_t c03 = averageByte4(c01, c23);
+			resolveBytes4(dest, source, sampleSliceB, rowBytes);
 
-					*(uint32_t *)(dest + 4 * x) = c03;
-				}
-
-				source0 += pitch;
-				source1 += pitch;
-				source2 += pitch;
-				source3 += pitch;
-				dest += pitch;
-
-				ASSERT(source0 < src->end());
-				ASSERT(source3 < src->end());
-				ASSERT(dest < dst->end());
-			}
+			source += srcPitchB;
+			dest += dstPitchB;
 		}
-		else
-			UNSUPPORTED("Samples: %d", samples);
-	}
-	else
-	{
-		return false;
-	}
+	});
 
-	dst->contentsChanged(dstSubresourceRange);
+	VkRect2D dstRect = {
+		{ region.dstOffset.x, region.dstOffset.y },
+		{ region.extent.width, region.extent.height }
+	};
+	dst->contentsChanged(dstSubresourceRange, vk::Image::DIRECT_MEMORY_ACCESS, &dstRect);
 
 	return true;
 }
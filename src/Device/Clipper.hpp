@@ -33,6 +33,7 @@ struct Clipper
 		CLIP_LEFT = 1 << 3,
 		CLIP_BOTTOM = 1 << 4,
 		CLIP_NEAR = 1 << 5,
+		CLIP_GUARD_BAND = 1 << 6,  // Outside the guard band, so side planes must be clipped against
 
 		CLIP_SIDES = CLIP_LEFT | CLIP_RIGHT | CLIP_BOTTOM | CLIP_TOP,
 		CLIP_FRUSTUM = CLIP_SIDES | CLIP_NEAR | CLIP_FAR,
@@ -420,6 +420,8 @@ struct FragmentOutputInterfaceState
 	// the attachment list with VK_KHR_dynamic_rendering_local_read.
 	BlendState getBlendState(int location, const Attachments &attachments, bool fragmentContainsKill) const;
 	int colorWriteActive(int location, const Attachments &attachments) const;
+	// Returns true if any color attachment is written to.
+	bool colorWriteActive(const Attachments &attachments) const;
 
 private:
 	void setColorBlendState(const VkPipelineColorBlendStateCreateInfo *colorBlendState);
@@ -428,7 +430,6 @@ private:
 	VkBlendOp blendOperation(VkBlendOp blendOperation, VkBlendFactor sourceBlendFactor, VkBlendFactor destBlendFactor, vk::Format format) const;
 
 	bool alphaBlendActive(int location, const Attachments &attachments, bool fragmentContainsKill) const;
-	bool colorWriteActive(const Attachments &attachments) const;
 
 	int colorWriteMask[sw::MAX_COLOR_BUFFERS] = {};  // RGBA
 
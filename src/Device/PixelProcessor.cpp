@@ -18,24 +18,59 @@
 #include "Pipeline/Constants.hpp"
 #include "Pipeline/PixelProgram.hpp"
 #include "System/Debug.hpp"
+#include "System/Math.hpp"
 #include "Vulkan/VkImageView.hpp"
 #include "Vulkan/VkPipelineLayout.hpp"
 
 #include <cstring>
 
-namespace sw {
+namespace {
 
-uint32_t PixelProcessor::States::computeHash()
+bool isFixedPointBlendFactor(VkBlendFactor blendFactor)
 {
-	uint32_t *state = reinterpret_cast<uint32_t *>(this);
-	uint32_t hash = 0;
+	switch(blendFactor)
+	{
+	case VK_BLEND_FACTOR_ZERO:
+	case VK_BLEND_FACTOR_ONE:
+	case VK_BLEND_FACTOR_SRC_COLOR:
+	case VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR:
+	case VK_BLEND_FACTOR_DST_COLOR:
+	case VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR:
+	case VK_BLEND_FACTOR_SRC_ALPHA:
+	case VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA:
+	case VK_BLEND_FACTOR_DST_ALPHA:
+	case VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA:
+	case VK_BLEND_FACTOR_SRC_ALPHA_SATURATE:
+		return true;
+	default:
+		return false;
+	}
+}
 
-	for(unsigned int i = 0; i < sizeof(States) / sizeof(uint32_t); i++)
+bool isFixedPointBlendOp(VkBlendOp blendOperation)
+{
+	switch(blendOperation)
 	{
-		hash ^= state[i];
+	case VK_BLEND_OP_ADD:
+	case VK_BLEND_OP_SUBTRACT:
+	case VK_BLEND_OP_REVERSE_SUBTRACT:
+	case VK_BLEND_OP_MIN:
+	case VK_BLEND_OP_MAX:
+		return true;
+	default:
+		return false;
 	}
+}
 
-	return hash;
+}  // anonymous namespace
+
+namespace sw {
+
+uint32_t PixelProcessor::States::computeHash()
+{
+	uint64_t hash = FNV_1a(reinterpret_cast<const unsigned char *>(this), sizeof(States));
+
+	return static_cast<uint32_t>(hash ^ (hash >> 32));
 }
 
 bool PixelProcessor::State::operator==(const State &state) const
@@ -45,7 +80,50 @@ bool PixelProcessor::State::operator==(const State &state) const
 		return false;
 	}
 
-	return *static_cast<const States *>(this) == static_cast<const States &>(state);
+	if(!(*static_cast<const States *>(this) == static_cast<const States &>(state)))
+	{
+		return false;
+	}
+
+	return !specializedPushConstants || (memcmp(pushConstants, state.pushConstants, sizeof(pushConstants)) == 0);
+}
+
+void PixelProcessor::State::specializeForPushConstants(const uint8_t *data, uint32_t begin, uint32_t end)
+{
+	// Bytes outside of the pipeline layouts' ranges may be left over from other
+	// pipelines, so they're cleared to not distinguish otherwise equal states.
+	memset(pushConstants, 0, sizeof(pushConstants));
+	memcpy(&pushConstants[begin], &data[begin], end - begin);
+
+	specializedPushConstants = true;
+	pushConstantsHash = static_cast<uint32_t>(FNV_1a(pushConstants, sizeof(pushConstants)));
+	hash = computeHash();
+}
+
+bool PixelProcessor::State::fixedPointBlend(int index) const
+{
+	const vk::BlendState &blend = blendState[index];
+
+	if(!blend.alphaBlendEnable)
+	{
+		return false;
+	}
+
+	switch(colorFormat[index])
+	{
+	case VK_FORMAT_R8G8B8A8_UNORM:
+	case VK_FORMAT_B8G8R8A8_UNORM:
+		break;
+	default:
+		return false;
+	}
+
+	return isFixedPointBlendOp(blend.blendOperation) &&
+	       isFixedPointBlendOp(blend.blendOperationAlpha) &&
+	       isFixedPointBlendFactor(blend.sourceBlendFactor) &&
+	       isFixedPointBlendFactor(blend.destBlendFactor) &&
+	       isFixedPointBlendFactor(blend.sourceBlendFactorAlpha) &&
+	       isFixedPointBlendFactor(blend.destBlendFactorAlpha);
 }
 
 PixelProcessor::PixelProcessor()
@@ -71,7 +149,7 @@ void PixelProcessor::setRoutineCacheSize(int cacheSize)
 	routineCache = std::make_unique<RoutineCacheType>(clamp(cacheSize, 1, 65536));
 }
 
-const PixelProcessor::State PixelProcessor::update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *fragmentShader, const sw::SpirvShader *vertexShader, const vk::Attachments &attachments, bool occlusionEnabled) const
+const PixelProcessor::State PixelProcessor::update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *fragmentShader, const sw::SpirvShader *vertexShader, const vk::Attachments &attachments, bool occlusionEnabled, bool occlusionPrecise) const
 {
 	const vk::VertexInputInterfaceState &vertexInputInterfaceState = pipelineState.getVertexInputInterfaceState();
 	const vk::PreRasterizationState &preRasterizationState = pipelineState.getPreRasterizationState();
@@ -137,6 +215,7 @@ const PixelProcessor::State PixelProcessor::update(const vk::GraphicsState &pipe
 	}
 
 	state.occlusionEnabled = occlusionEnabled;
+	state.occlusionPrecise = occlusionEnabled && occlusionPrecise;
 
 	bool fragmentContainsDiscard = (fragmentShader && fragmentShader->getAnalysis().ContainsDiscard);
 	for(uint32_t location = 0; location < MAX_COLOR_BUFFERS; location++)
@@ -181,6 +260,14 @@ const PixelProcessor::State PixelProcessor::update(const vk::GraphicsState &pipe
 
 	state.frontFace = preRasterizationState.getFrontFace();
 
+	// Draws which write no attachments and run no shader with side effects only affect the
+	// occlusion query. If it merely needs to know whether any sample passed, rendering can
+	// stop early. Vertex shaders with side effects must still run for every vertex.
+	const bool stencilWriteActive = state.stencilActive && (state.frontStencil.writeEnabled || state.backStencil.writeEnabled);
+	state.occlusionOnly = occlusionEnabled && !occlusionPrecise && !fragmentShader &&
+	                      !(vertexShader && vertexShader->containsSideEffects()) &&
+	                      !state.depthWriteEnable && !stencilWriteActive && (state.colorWriteMask == 0);
+
 	state.hash = state.computeHash();
 
 	return state;
@@ -83,6 +83,8 @@ public:
 		bool depthTestActive;
 		bool depthBoundsTestActive;
 		bool occlusionEnabled;
+		bool occlusionPrecise;  // Exact sample counts are required, not just visibility
+		bool occlusionOnly;     // The occlusion query result is the only effect of the draw
 		bool perspective;
 
 		vk::BlendState blendState[MAX_COLOR_BUFFERS];
@@ -105,6 +107,9 @@ public:
 
 		float minDepthClamp;
 		float maxDepthClamp;
+
+		bool specializedPushConstants;
+		uint32_t pushConstantsHash;  // Digest of pushConstants, zero when not specialized
 	};
 
 	struct State : States
@@ -116,7 +121,18 @@ public:
 			return (colorWriteMask >> (index * 4)) & 0xF;
 		}
 
+		// Returns true if blending into the attachment can be performed using 16-bit
+		// fixed-point arithmetic, which is precise enough for 8-bit UNORM formats.
+		bool fixedPointBlend(int index) const;
+
+		void specializeForPushConstants(const uint8_t *data, uint32_t begin, uint32_t end);
+
 		uint32_t hash;
+
+		// Push constant values which the routine is specialized for. Left
+		// uninitialized, and excluded from hashing and comparison, unless
+		// specializedPushConstants is set.
+		uint8_t pushConstants[vk::MAX_PUSH_CONSTANT_SIZE];
 	};
 
 	struct Stencil
@@ -163,7 +179,7 @@ public:
 
 	void setBlendConstant(const float4 &blendConstant);
 
-	const State update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *fragmentShader, const sw::SpirvShader *vertexShader, const vk::Attachments &attachments, bool occlusionEnabled) const;
+	const State update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *fragmentShader, const sw::SpirvShader *vertexShader, const vk::Attachments &attachments, bool occlusionEnabled, bool occlusionPrecise) const;
 	RoutineType routine(const State &state, const vk::PipelineLayout *pipelineLayout,
 	                    const SpirvShader *pixelShader, const vk::Attachments &attachments, const vk::DescriptorSet::Bindings &descriptorSets);
 	void setRoutineCacheSize(int routineCacheSize);
@@ -44,6 +44,10 @@ struct Primitive
 
 	float pointSizeInv;
 
+	// Nonzero when all vertices have the same w. Perspective-correct plane equations are
+	// then pre-multiplied by w, so they can be interpolated without perspective division.
+	int affine;
+
 	PlaneEquation z;
 	float zBias;
 	PlaneEquation w;
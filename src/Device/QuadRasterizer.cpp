@@ -38,8 +38,7 @@ void QuadRasterizer::generate()
 	constants = device + OFFSET(vk::Device, constants);
 	occlusion = 0;
 
-	Do
-	{
+	auto rasterizePrimitive = [&]() {
 		Int yMin = *Pointer<Int>(primitive + OFFSET(Primitive, yMin));
 		Int yMax = *Pointer<Int>(primitive + OFFSET(Primitive, yMax));
 
@@ -55,8 +54,25 @@ void QuadRasterizer::generate()
 
 		primitive += sizeof(Primitive) * state.multiSampleCount;
 		count--;
+	};
+
+	if(state.occlusionOnly)
+	{
+		// No further primitives can change the outcome once a sample is visible
+		Do
+		{
+			rasterizePrimitive();
+		}
+		Until(count == 0 || occlusion != 0);
+	}
+	else
+	{
+		Do
+		{
+			rasterizePrimitive();
+		}
+		Until(count == 0);
 	}
-	Until(count == 0);
 
 	if(state.occlusionEnabled)
 	{
@@ -25,6 +25,7 @@
 #include "System/Half.hpp"
 #include "System/Math.hpp"
 #include "System/Memory.hpp"
+#include "System/SwiftConfig.hpp"
 #include "System/Timer.hpp"
 #include "Vulkan/VkConfig.hpp"
 #include "Vulkan/VkDescriptorSet.hpp"
@@ -47,6 +48,36 @@ unsigned int maxPrimitives = 1 << 21;
 
 namespace sw {
 
+// Minimum number of varying components for which shading positions ahead of
+// culling outweighs evaluating them twice for the surviving vertices.
+static constexpr int MinPositionPreCullingVaryings = 8;
+
+// Maximum number of push constant values each resolved set of routines gets
+// specialized for, to bound compilation when the values change every so often.
+static constexpr uint32_t MaxPushConstantSpecializations = 4;
+
+// Number of recent draws whose vertex results later draws can be matched with.
+static constexpr size_t MaxVertexResults = 8;
+
+static bool usePositionPreCulling(const SpirvShader *vertexShader)
+{
+	if(!vertexShader || vertexShader->containsSideEffects())
+	{
+		return false;
+	}
+
+	int varyings = 0;
+	for(const auto &output : vertexShader->outputs)
+	{
+		if(output.Type != Spirv::ATTRIBTYPE_UNUSED)
+		{
+			varyings++;
+		}
+	}
+
+	return varyings >= MinPositionPreCullingVaryings;
+}
+
 template<typename T>
 inline bool setBatchIndices(unsigned int batch[128][3], VkPrimitiveTopology topology, VkProvokingVertexModeEXT provokingVertexMode, T indices, unsigned int start, unsigned int triangleCount)
 {
@@ -144,6 +175,94 @@ inline bool setBatchIndices(unsigned int batch[128][3], VkPrimitiveTopology topo
 	return true;
 }
 
+RoutineSignature::RoutineSignature(const vk::DynamicState &dynamicState, const vk::Inputs &inputs, const vk::Attachments &attachments,
+                                   bool occlusionEnabled, bool occlusionPrecise)
+    : Memset(this, 0)
+{
+	for(int i = 0; i < 4; i++)
+	{
+		blendConstants[i] = dynamicState.blendConstants[i];
+	}
+
+	depthBiasConstantFactor = dynamicState.depthBiasConstantFactor;
+	depthBiasClamp = dynamicState.depthBiasClamp;
+	depthBiasSlopeFactor = dynamicState.depthBiasSlopeFactor;
+	minDepthBounds = dynamicState.minDepthBounds;
+	maxDepthBounds = dynamicState.maxDepthBounds;
+	minDepth[0] = dynamicState.viewport.minDepth;
+	maxDepth[0] = dynamicState.viewport.maxDepth;
+	minDepth[1] = dynamicState.viewports[0].minDepth;
+	maxDepth[1] = dynamicState.viewports[0].maxDepth;
+
+	cullMode = dynamicState.cullMode;
+	depthBoundsTestEnable = dynamicState.depthBoundsTestEnable;
+	depthCompareOp = dynamicState.depthCompareOp;
+	depthTestEnable = dynamicState.depthTestEnable;
+	depthWriteEnable = dynamicState.depthWriteEnable;
+	frontFace = dynamicState.frontFace;
+	primitiveTopology = dynamicState.primitiveTopology;
+	faceMask = dynamicState.faceMask;
+	frontStencil = dynamicState.frontStencil;
+	backStencil = dynamicState.backStencil;
+	stencilTestEnable = dynamicState.stencilTestEnable;
+	rasterizerDiscardEnable = dynamicState.rasterizerDiscardEnable;
+	depthBiasEnable = dynamicState.depthBiasEnable;
+	primitiveRestartEnable = dynamicState.primitiveRestartEnable;
+
+	for(int i = 0; i < MAX_INTERFACE_COMPONENTS / 4; i++)
+	{
+		inputFormat[i] = inputs.getStream(i).format;
+	}
+
+	for(int location = 0; location < MAX_COLOR_BUFFERS; location++)
+	{
+		colorFormat[location] = attachments.colorFormat(location);
+		indexToLocation[location] = attachments.indexToLocation[location];
+	}
+
+	depthFormat = attachments.depthFormat();
+	stencilFormat = attachments.stencilBuffer ? static_cast<VkFormat>(attachments.stencilBuffer->getFormat()) : VK_FORMAT_UNDEFINED;
+
+	this->occlusionEnabled = occlusionEnabled;
+	this->occlusionPrecise = occlusionPrecise;
+}
+
+uint64_t RoutineSignature::hash() const
+{
+	return FNV_1a(reinterpret_cast<const unsigned char *>(this), sizeof(RoutineSignature));
+}
+
+VertexResultKey::VertexResultKey(const DrawData &data, const VertexProcessor::RoutineType &vertexRoutine, const VertexProcessor::RoutineType &positionRoutine)
+    : Memset(this, 0)
+{
+	this->vertexRoutine = reinterpret_cast<const void *>(vertexRoutine.getEntry());
+	this->positionRoutine = reinterpret_cast<const void *>(positionRoutine.getEntry());
+
+	descriptorSets = data.descriptorSets;
+	descriptorDynamicOffsets = data.descriptorDynamicOffsets;
+
+	for(int i = 0; i < MAX_INTERFACE_COMPONENTS / 4; i++)
+	{
+		input[i] = data.input[i];
+		robustnessSize[i] = data.robustnessSize[i];
+		stride[i] = data.stride[i];
+	}
+
+	instanceID = data.instanceID;
+	baseVertex = data.baseVertex;
+	layer = data.layer;
+
+	// The viewport transform determines the projected and clipped vertex positions.
+	WxF = data.WxF;
+	HxF = data.HxF;
+	X0xF = data.X0xF;
+	Y0xF = data.Y0xF;
+	guardBandX = data.guardBandX;
+	guardBandY = data.guardBandY;
+
+	pushConstants = data.pushConstants;
+}
+
 DrawCall::DrawCall()
 {
 	// TODO(b/140991626): Use allocateUninitialized() instead of allocateZeroOrPoison() to improve startup peformance.
@@ -156,7 +275,10 @@ DrawCall::~DrawCall()
 }
 
 Renderer::Renderer(vk::Device *device)
-    : device(device)
+    : guardBandSize(std::min<int>(getConfiguration().guardBandSize, vk::MAX_GUARD_BAND_SIZE))
+    , pushConstantSpecializationDraws(getConfiguration().pushConstantSpecializationDraws)
+    , vertexResultReuse(getConfiguration().enableVertexResultReuse)
+    , device(device)
 {
 	vertexProcessor.setRoutineCacheSize(1024);
 	pixelProcessor.setRoutineCacheSize(1024);
@@ -222,6 +344,34 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 
 	const vk::Inputs &inputs = pipeline->getInputs();
 
+	// Pipelines memoize the routines resolved for each dynamic state signature, so that
+	// alternating between a few pipelines doesn't rebuild and look up the states.
+	std::shared_ptr<ResolvedRoutines> resolved;
+	uint64_t signatureHash = 0;
+	if(update)
+	{
+		const RoutineSignature signature(dynamicState, inputs, pipeline->getAttachments(), hasOcclusionQuery(), hasOcclusionQuery() && occlusionQuery->isPrecise());
+		signatureHash = signature.hash();
+
+		resolved = pipeline->getResolvedRoutines(signatureHash);
+		if(resolved && (resolved->signature == signature))
+		{
+			vertexState = resolved->vertexState;
+			setupState = resolved->setupState;
+			pixelState = resolved->pixelState;
+			vertexRoutine = resolved->vertexRoutine;
+			positionRoutine = resolved->positionRoutine;
+			setupRoutine = resolved->setupRoutine;
+			pixelRoutine = resolved->pixelRoutine;
+
+			update = false;
+		}
+		else
+		{
+			resolved = std::make_shared<ResolvedRoutines>(signature);
+		}
+	}
+
 	if(update)
 	{
 		MARL_SCOPED_EVENT("update");
@@ -231,17 +381,63 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 
 		const vk::Attachments attachments = pipeline->getAttachments();
 
-		vertexState = vertexProcessor.update(pipelineState, vertexShader, inputs);
+		// A fragment shader which only produces color has no observable effect when no
+		// color is written, so depth/stencil-only passes can skip it altogether.
+		if(fragmentShader && !hasRasterizerDiscard &&
+		   !fragmentShader->hasNonColorEffects() &&
+		   !fragmentOutputInterfaceState->colorWriteActive(attachments) &&
+		   !fragmentOutputInterfaceState->hasAlphaToCoverage())
+		{
+			fragmentShader = nullptr;
+		}
+
+		// Without a fragment shader, only vertex positions are needed.
+		const bool positionOnly = hasRasterizerDiscard || !fragmentShader;
+
+		vertexState = vertexProcessor.update(pipelineState, vertexShader, inputs, positionOnly);
 		vertexRoutine = vertexProcessor.routine(vertexState, preRasterizationState.getPipelineLayout(), vertexShader, inputs.getDescriptorSets());
 
+		// Vertex shaders producing many varyings first shade only positions, so that the full
+		// routine runs just for the vertices of filled triangles which survive culling. Shaders
+		// with side effects must run exactly once for every vertex.
+		positionRoutine = {};
+		if(!positionOnly && usePositionPreCulling(vertexShader) &&
+		   vertexInputInterfaceState.isDrawTriangle(false, preRasterizationState.getPolygonMode()) &&
+		   (preRasterizationState.getPolygonMode() == VK_POLYGON_MODE_FILL))
+		{
+			const VertexProcessor::State positionState = vertexProcessor.update(pipelineState, vertexShader, inputs, true);
+			positionRoutine = vertexProcessor.routine(positionState, preRasterizationState.getPipelineLayout(), vertexShader, inputs.getDescriptorSets());
+		}
+
 		if(!hasRasterizerDiscard)
 		{
 			setupState = setupProcessor.update(pipelineState, fragmentShader, vertexShader, attachments);
 			setupRoutine = setupProcessor.routine(setupState);
 
-			pixelState = pixelProcessor.update(pipelineState, fragmentShader, vertexShader, attachments, hasOcclusionQuery());
+			pixelState = pixelProcessor.update(pipelineState, fragmentShader, vertexShader, attachments, hasOcclusionQuery(), hasOcclusionQuery() && occlusionQuery->isPrecise());
 			pixelRoutine = pixelProcessor.routine(pixelState, fragmentState->getPipelineLayout(), fragmentShader, attachments, inputs.getDescriptorSets());
 		}
+
+		resolved->vertexState = vertexState;
+		resolved->setupState = setupState;
+		resolved->pixelState = pixelState;
+		resolved->vertexRoutine = vertexRoutine;
+		resolved->positionRoutine = positionRoutine;
+		resolved->setupRoutine = setupRoutine;
+		resolved->pixelRoutine = pixelRoutine;
+		pipeline->setResolvedRoutines(signatureHash, resolved);
+	}
+
+	if(resolved)
+	{
+		resolvedRoutines = resolved;
+	}
+
+	VertexProcessor::RoutineType drawVertexRoutine = vertexRoutine;
+	PixelProcessor::RoutineType drawPixelRoutine = pixelRoutine;
+	if(pushConstantSpecializationDraws > 0)
+	{
+		specializeForPushConstants(pipeline, pipelineState, pushConstants, drawVertexRoutine, drawPixelRoutine);
 	}
 
 	draw->preRasterizationContainsImageWrite = pipeline->preRasterizationContainsImageWrite();
@@ -256,6 +452,8 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 
 	DrawData *data = draw->data;
 	draw->occlusionQuery = occlusionQuery;
+	draw->occlusionOnly = !hasRasterizerDiscard && pixelState.occlusionOnly;
+	draw->occlusionVisible = false;
 	draw->batchDataPool = &batchDataPool;
 	draw->numPrimitives = count;
 	draw->numPrimitivesPerBatch = numPrimitivesPerBatch;
@@ -287,7 +485,8 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 	data->baseVertex = baseVertex;
 	draw->indexType = indexBuffer ? pipeline->getIndexBuffer().getIndexType() : VK_INDEX_TYPE_UINT16;
 
-	draw->vertexRoutine = vertexRoutine;
+	draw->vertexRoutine = drawVertexRoutine;
+	draw->positionRoutine = positionRoutine;
 
 	vk::DescriptorSet::PrepareForSampling(draw->descriptorSetObjects, draw->preRasterizationPipelineLayout, device);
 
@@ -310,6 +509,13 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 		data->Y0xF = Y0 * subPixF - subPixF / 2;
 		data->halfPixelX = 0.5f / W;
 		data->halfPixelY = 0.5f / H;
+
+		// The guard band is only used for pixel-aligned viewports, so that clamping the
+		// scissor rectangle to the viewport discards exactly the fragments outside of it.
+		bool pixelAligned = (viewport.x == floor(viewport.x)) && (viewport.y == floor(viewport.y)) &&
+		                    (viewport.width == floor(viewport.width)) && (viewport.height == floor(viewport.height));
+		data->guardBandX = pixelAligned ? std::max(guardBandSize / viewport.width, 1.0f) : 1.0f;
+		data->guardBandY = pixelAligned ? std::max(guardBandSize / std::abs(viewport.height), 1.0f) : 1.0f;
 		data->depthRange = Z;
 		data->depthNear = N;
 		data->constantDepthBias = preRasterizationState.getConstantDepthBias();
@@ -336,6 +542,22 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 		data->scissorX1 = clamp<int>(scissor.offset.x + scissor.extent.width, x0, x1);
 		data->scissorY0 = clamp<int>(scissor.offset.y, y0, y1);
 		data->scissorY1 = clamp<int>(scissor.offset.y + scissor.extent.height, y0, y1);
+
+		// Triangles within the guard band aren't clipped against the viewport sides.
+		if(data->guardBandX > 1.0f || data->guardBandY > 1.0f)
+		{
+			const VkViewport &viewport = preRasterizationState.getViewport();
+
+			int viewportX0 = static_cast<int>(viewport.x);
+			int viewportX1 = static_cast<int>(viewport.x + viewport.width);
+			int viewportY0 = static_cast<int>(std::min(viewport.y, viewport.y + viewport.height));
+			int viewportY1 = static_cast<int>(std::max(viewport.y, viewport.y + viewport.height));
+
+			data->scissorX0 = clamp(data->scissorX0, viewportX0, viewportX1);
+			data->scissorX1 = clamp(data->scissorX1, viewportX0, viewportX1);
+			data->scissorY0 = clamp(data->scissorY0, viewportY0, viewportY1);
+			data->scissorY1 = clamp(data->scissorY1, viewportY0, viewportY1);
+		}
 	}
 
 	if(!hasRasterizerDiscard)
@@ -374,7 +596,7 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 
 		draw->setupState = setupState;
 		draw->setupRoutine = setupRoutine;
-		draw->pixelRoutine = pixelRoutine;
+		draw->pixelRoutine = drawPixelRoutine;
 		draw->setupPrimitives = setupPrimitives;
 		draw->fragmentPipelineLayout = fragmentState->getPipelineLayout();
 
@@ -482,11 +704,42 @@ void Renderer::draw(const vk::GraphicsPipeline *pipeline, const vk::DynamicState
 		data->pushConstants = pushConstants;
 	}
 
+	draw->vertexCacheId = vertexResultReuse ? findVertexCacheId(pipeline, draw.get()) : id;
+
 	draw->events = events;
 
 	DrawCall::run(device, draw, &drawTickets, clusterQueues);
 }
 
+int Renderer::findVertexCacheId(const vk::GraphicsPipeline *pipeline, const DrawCall *draw)
+{
+	// Shaders with side effects must run for every vertex of every draw.
+	const sw::SpirvShader *vertexShader = pipeline->getShader(VK_SHADER_STAGE_VERTEX_BIT).get();
+	if(!vertexShader || vertexShader->containsSideEffects())
+	{
+		return draw->id;
+	}
+
+	// Vertex caches are tagged with the vertex index, so draws which shade the same vertices
+	// can share their contents regardless of the index buffer.
+	const VertexResultKey key(*draw->data, draw->vertexRoutine, draw->positionRoutine);
+	for(const auto &results : vertexResults)
+	{
+		if(results.key == key)
+		{
+			return results.vertexCacheId;
+		}
+	}
+
+	if(vertexResults.size() == MaxVertexResults)
+	{
+		vertexResults.erase(vertexResults.begin());
+	}
+	vertexResults.push_back({ key, draw->id, draw->vertexRoutine, draw->positionRoutine });
+
+	return draw->id;
+}
+
 void DrawCall::setup()
 {
 	if(occlusionQuery != nullptr)
@@ -500,6 +753,81 @@ void DrawCall::setup()
 	}
 }
 
+void Renderer::specializeForPushConstants(const vk::GraphicsPipeline *pipeline, const vk::GraphicsState &pipelineState,
+                                          const vk::Pipeline::PushConstantStorage &pushConstants,
+                                          VertexProcessor::RoutineType &drawVertexRoutine, PixelProcessor::RoutineType &drawPixelRoutine)
+{
+	const vk::PreRasterizationState &preRasterizationState = pipelineState.getPreRasterizationState();
+	const bool hasRasterizerDiscard = preRasterizationState.hasRasterizerDiscard();
+	const vk::PipelineLayout *vertexLayout = preRasterizationState.getPipelineLayout();
+	const vk::PipelineLayout *fragmentLayout = hasRasterizerDiscard ? nullptr : pipelineState.getFragmentState().getPipelineLayout();
+
+	// Only the ranges declared by the pipeline layouts are compared, since the
+	// remaining push constants may be left over from other pipelines.
+	uint32_t begin = vk::MAX_PUSH_CONSTANT_SIZE;
+	uint32_t end = 0;
+	for(const vk::PipelineLayout *layout : { vertexLayout, fragmentLayout })
+	{
+		for(uint32_t i = 0; layout && (i < layout->getPushConstantRangeCount()); i++)
+		{
+			const VkPushConstantRange &range = layout->getPushConstantRange(i);
+			begin = std::min(begin, range.offset);
+			end = std::max(end, range.offset + range.size);
+		}
+	}
+
+	if(!resolvedRoutines || (begin >= end))
+	{
+		return;
+	}
+
+	ResolvedRoutines &resolved = *resolvedRoutines;
+	marl::lock lock(resolved.specializationMutex);
+
+	if(memcmp(&resolved.stablePushConstants.data[begin], &pushConstants.data[begin], end - begin) != 0)
+	{
+		memcpy(&resolved.stablePushConstants.data[begin], &pushConstants.data[begin], end - begin);
+		resolved.stableDrawCount = 1;
+		resolved.specializedVertexRoutine = {};
+		resolved.specializedPixelRoutine = {};
+
+		return;
+	}
+
+	if(!resolved.specializedVertexRoutine)
+	{
+		// Push constants which keep changing after being specialized for are not
+		// worth building further routines for.
+		if((++resolved.stableDrawCount < pushConstantSpecializationDraws) ||
+		   (resolved.specializationCount >= MaxPushConstantSpecializations))
+		{
+			return;
+		}
+
+		resolved.specializationCount++;
+
+		const vk::Inputs &inputs = pipeline->getInputs();
+
+		VertexProcessor::State specializedVertexState = resolved.vertexState;
+		specializedVertexState.specializeForPushConstants(pushConstants.data, begin, end);
+		resolved.specializedVertexRoutine = vertexProcessor.routine(specializedVertexState, vertexLayout, pipeline->getShader(VK_SHADER_STAGE_VERTEX_BIT).get(), inputs.getDescriptorSets());
+
+		// A pixel state without a shader ID was resolved for a draw which skips the fragment shader.
+		if(!hasRasterizerDiscard && (resolved.pixelState.shaderID != 0))
+		{
+			PixelProcessor::State specializedPixelState = resolved.pixelState;
+			specializedPixelState.specializeForPushConstants(pushConstants.data, begin, end);
+			resolved.specializedPixelRoutine = pixelProcessor.routine(specializedPixelState, fragmentLayout, pipeline->getShader(VK_SHADER_STAGE_FRAGMENT_BIT).get(), pipeline->getAttachments(), inputs.getDescriptorSets());
+		}
+	}
+
+	drawVertexRoutine = resolved.specializedVertexRoutine;
+	if(resolved.specializedPixelRoutine)
+	{
+		drawPixelRoutine = resolved.specializedPixelRoutine;
+	}
+}
+
 void DrawCall::teardown(vk::Device *device)
 {
 	if(events)
@@ -509,6 +837,7 @@ void DrawCall::teardown(vk::Device *device)
 	}
 
 	vertexRoutine = {};
+	positionRoutine = {};
 	setupRoutine = {};
 	pixelRoutine = {};
 
@@ -574,9 +903,16 @@ void DrawCall::run(vk::Device *device, const marl::Loan<DrawCall> &draw, marl::T
 		}
 
 		marl::schedule([device, draw, batch, finally] {
-			processVertices(device, draw.get(), batch.get());
+			// Once a sample is known to be visible, the remaining batches of an
+			// occlusion-only draw cannot affect the result.
+			const bool skip = draw->occlusionOnly && draw->occlusionVisible;
+
+			if(!skip)
+			{
+				processVertices(device, draw.get(), batch.get());
+			}
 
-			if(!draw->data->rasterizerDiscard)
+			if(!skip && !draw->data->rasterizerDiscard)
 			{
 				processPrimitives(device, draw.get(), batch.get());
 
@@ -612,14 +948,55 @@ void DrawCall::processVertices(vk::Device *device, DrawCall *draw, BatchData *ba
 		    draw->provokingVertexMode);
 	}
 
+	if(draw->positionRoutine)
+	{
+		MARL_SCOPED_EVENT("positionRoutine");
+
+		auto &positionTask = batch->positionTask;
+		positionTask.primitiveStart = batch->firstPrimitive;
+		positionTask.vertexCount = batch->numPrimitives * 3;
+		if(positionTask.vertexCache.drawCall != draw->vertexCacheId)
+		{
+			positionTask.vertexCache.clear();
+			positionTask.vertexCache.drawCall = draw->vertexCacheId;
+		}
+
+		draw->positionRoutine(device, &batch->triangles.front().v0, &triangleIndices[0][0], &positionTask, draw->data);
+
+		// Compact the indices of the surviving triangles, preserving their order.
+		unsigned int survivors = 0;
+		for(unsigned int i = 0; i < batch->numPrimitives; i++)
+		{
+			if(!isTriangleCulled(batch->triangles[i], *draw))
+			{
+				triangleIndices[survivors][0] = triangleIndices[i][0];
+				triangleIndices[survivors][1] = triangleIndices[i][1];
+				triangleIndices[survivors][2] = triangleIndices[i][2];
+				survivors++;
+			}
+		}
+
+		batch->numPrimitives = survivors;
+
+		if(survivors == 0)
+		{
+			return;
+		}
+
+		// Repeat the last index to allow for SIMD width overrun.
+		triangleIndices[survivors][0] = triangleIndices[survivors - 1][2];
+		triangleIndices[survivors][1] = triangleIndices[survivors - 1][2];
+		triangleIndices[survivors][2] = triangleIndices[survivors - 1][2];
+	}
+
 	auto &vertexTask = batch->vertexTask;
 	vertexTask.primitiveStart = batch->firstPrimitive;
 	// We're only using batch compaction for points, not lines
 	vertexTask.vertexCount = batch->numPrimitives * ((draw->topology == VK_PRIMITIVE_TOPOLOGY_POINT_LIST) ? 1 : 3);
-	if(vertexTask.vertexCache.drawCall != draw->id)
+	if(vertexTask.vertexCache.drawCall != draw->vertexCacheId)
 	{
 		vertexTask.vertexCache.clear();
-		vertexTask.vertexCache.drawCall = draw->id;
+		vertexTask.vertexCache.drawCall = draw->vertexCacheId;
 	}
 
 	draw->vertexRoutine(device, &batch->triangles.front().v0, &triangleIndices[0][0], &vertexTask, draw->data);
@@ -653,7 +1030,14 @@ void DrawCall::processPixels(vk::Device *device, const marl::Loan<DrawCall> &dra
 			auto &draw = data->draw;
 			auto &batch = data->batch;
 			MARL_SCOPED_EVENT("PIXEL draw %d, batch %d, cluster %d", draw->id, batch->id, cluster);
-			draw->pixelRoutine(device, &batch->primitives.front(), batch->numVisible, cluster, MaxClusterCount, draw->data);
+			if(!(draw->occlusionOnly && draw->occlusionVisible))
+			{
+				draw->pixelRoutine(device, &batch->primitives.front(), batch->numVisible, cluster, MaxClusterCount, draw->data);
+			}
+			if(draw->occlusionOnly && (draw->data->occlusion[cluster] != 0))
+			{
+				draw->occlusionVisible = true;
+			}
 			batch->clusterTickets[cluster].done();
 		});
 	}
@@ -666,6 +1050,13 @@ void Renderer::synchronize()
 	ticket.wait();
 	device->updateSamplingRoutineSnapshotCache();
 	ticket.done();
+
+	invalidateVertexResults();
+}
+
+void Renderer::invalidateVertexResults()
+{
+	vertexResults.clear();
 }
 
 void DrawCall::processPrimitiveVertices(
@@ -749,13 +1140,15 @@ int DrawCall::setupSolidTriangles(vk::Device *device, Triangle *triangles, Primi
 			continue;
 		}
 
-		if((v0.clipFlags & v1.clipFlags & v2.clipFlags) != Clipper::CLIP_FINITE)
+		if((v0.clipFlags & v1.clipFlags & v2.clipFlags & (Clipper::CLIP_FRUSTUM | Clipper::CLIP_FINITE)) != Clipper::CLIP_FINITE)
 		{
 			continue;
 		}
 
+		// Triangles which only cross the viewport sides within the guard band are not clipped.
+		// The scissor rectangle discards their fragments outside of the viewport instead.
 		int clipFlagsOr = v0.clipFlags | v1.clipFlags | v2.clipFlags;
-		if(clipFlagsOr != Clipper::CLIP_FINITE)
+		if(clipFlagsOr & (Clipper::CLIP_GUARD_BAND | Clipper::CLIP_NEAR | Clipper::CLIP_FAR))
 		{
 			if(!Clipper::Clip(polygon, clipFlagsOr, *drawCall))
 			{
@@ -773,6 +1166,63 @@ int DrawCall::setupSolidTriangles(vk::Device *device, Triangle *triangles, Primi
 	return visible;
 }
 
+// Returns true if the triangle is certain to be rejected by setupSolidTriangles(),
+// based on the positions, clip flags and cull mask produced by the position routine.
+bool DrawCall::isTriangleCulled(const Triangle &triangle, const DrawCall &draw)
+{
+	const Vertex &v0 = triangle.v0;
+	const Vertex &v1 = triangle.v1;
+	const Vertex &v2 = triangle.v2;
+
+	if((v0.cullMask | v1.cullMask | v2.cullMask) == 0)
+	{
+		return true;
+	}
+
+	if((v0.clipFlags & v1.clipFlags & v2.clipFlags & (Clipper::CLIP_FRUSTUM | Clipper::CLIP_FINITE)) != Clipper::CLIP_FINITE)
+	{
+		return true;
+	}
+
+	auto &state = draw.setupState;
+
+	if(state.cullMode == VK_CULL_MODE_NONE)
+	{
+		return false;
+	}
+
+	float t0 = ((float)v0.projected.y - (float)v2.projected.y) * (float)v1.projected.x;
+	float t1 = ((float)v2.projected.y - (float)v1.projected.y) * (float)v0.projected.x;
+	float t2 = ((float)v1.projected.y - (float)v0.projected.y) * (float)v2.projected.x;
+	float A = t0 + t1 + t2;  // Area
+
+	// The setup routine evaluates the same expression, but may round it differently.
+	// Leave near-degenerate triangles for it to decide.
+	if(std::abs(A) <= (std::abs(t0) + std::abs(t1) + std::abs(t2)) * (1.0f / 65536))
+	{
+		return false;
+	}
+
+	int w0w1w2 = bit_cast<int>(v0.w) ^
+	             bit_cast<int>(v1.w) ^
+	             bit_cast<int>(v2.w);
+
+	A = w0w1w2 < 0 ? -A : A;
+
+	bool frontFacing = (state.frontFace == VK_FRONT_FACE_COUNTER_CLOCKWISE) ? (A >= 0.0f) : (A <= 0.0f);
+
+	if(state.cullMode & VK_CULL_MODE_FRONT_BIT)
+	{
+		if(frontFacing) return true;
+	}
+	if(state.cullMode & VK_CULL_MODE_BACK_BIT)
+	{
+		if(!frontFacing) return true;
+	}
+
+	return false;
+}
+
 int DrawCall::setupWireframeTriangles(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count)
 {
 	auto &state = drawCall->setupState;
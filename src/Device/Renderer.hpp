@@ -23,10 +23,12 @@
 #include "Vulkan/VkPipeline.hpp"
 
 #include "marl/finally.h"
+#include "marl/mutex.h"
 #include "marl/pool.h"
 #include "marl/ticket.h"
 
 #include <atomic>
+#include <vector>
 
 namespace vk {
 
@@ -80,6 +82,8 @@ struct DrawData
 	float Y0xF;
 	float halfPixelX;
 	float halfPixelY;
+	float guardBandX;  // Guard band half-extent, in units of the viewport half-extent
+	float guardBandY;
 	float depthRange;
 	float depthNear;
 	float minimumResolvableDepthDifference;
@@ -112,6 +116,108 @@ struct DrawData
 	bool rasterizerDiscard;
 };
 
+// Everything besides the pipeline itself which determines the routines of a draw.
+// The viewport rectangle and scissor only affect DrawData, so they are left out.
+struct RoutineSignature : Memset<RoutineSignature>
+{
+	RoutineSignature(const vk::DynamicState &dynamicState, const vk::Inputs &inputs, const vk::Attachments &attachments,
+	                 bool occlusionEnabled, bool occlusionPrecise);
+
+	uint64_t hash() const;
+
+	float blendConstants[4];
+	float depthBiasConstantFactor;
+	float depthBiasClamp;
+	float depthBiasSlopeFactor;
+	float minDepthBounds;
+	float maxDepthBounds;
+	float minDepth[2];  // Of the viewport and of the first of the viewports
+	float maxDepth[2];
+
+	VkCullModeFlags cullMode;
+	VkBool32 depthBoundsTestEnable;
+	VkCompareOp depthCompareOp;
+	VkBool32 depthTestEnable;
+	VkBool32 depthWriteEnable;
+	VkFrontFace frontFace;
+	VkPrimitiveTopology primitiveTopology;
+	VkStencilFaceFlags faceMask;
+	VkStencilOpState frontStencil;
+	VkStencilOpState backStencil;
+	VkBool32 stencilTestEnable;
+	VkBool32 rasterizerDiscardEnable;
+	VkBool32 depthBiasEnable;
+	VkBool32 primitiveRestartEnable;
+
+	VkFormat inputFormat[MAX_INTERFACE_COMPONENTS / 4];
+	VkFormat colorFormat[MAX_COLOR_BUFFERS];
+	uint32_t indexToLocation[MAX_COLOR_BUFFERS];
+	VkFormat depthFormat;
+	VkFormat stencilFormat;
+
+	bool occlusionEnabled;
+	bool occlusionPrecise;
+};
+
+// Routine states and routines resolved for a graphics pipeline, which the
+// pipeline memoizes for each distinct RoutineSignature.
+struct ResolvedRoutines
+{
+	ResolvedRoutines(const RoutineSignature &signature)
+	    : signature(signature)
+	{}
+
+	const RoutineSignature signature;
+
+	VertexProcessor::State vertexState;
+	SetupProcessor::State setupState;
+	PixelProcessor::State pixelState;
+
+	VertexProcessor::RoutineType vertexRoutine;
+	VertexProcessor::RoutineType positionRoutine;
+	SetupProcessor::RoutineType setupRoutine;
+	PixelProcessor::RoutineType pixelRoutine;
+
+	// Push constant values seen by consecutive draws, and the routines specialized
+	// for them. Queues may draw with the same pipeline concurrently.
+	marl::mutex specializationMutex;
+	vk::Pipeline::PushConstantStorage stablePushConstants GUARDED_BY(specializationMutex) = {};
+	uint32_t stableDrawCount GUARDED_BY(specializationMutex) = 0;
+	uint32_t specializationCount GUARDED_BY(specializationMutex) = 0;
+	VertexProcessor::RoutineType specializedVertexRoutine GUARDED_BY(specializationMutex);
+	PixelProcessor::RoutineType specializedPixelRoutine GUARDED_BY(specializationMutex);
+};
+
+// Everything which determines the vertex a draw shades for a given index, besides the
+// contents of the memory it reads. Draws with equal keys can share vertex cache entries.
+struct VertexResultKey : Memset<VertexResultKey>
+{
+	VertexResultKey(const DrawData &data, const VertexProcessor::RoutineType &vertexRoutine, const VertexProcessor::RoutineType &positionRoutine);
+
+	const void *vertexRoutine;
+	const void *positionRoutine;
+
+	vk::DescriptorSet::Bindings descriptorSets;
+	vk::DescriptorSet::DynamicOffsets descriptorDynamicOffsets;
+
+	const void *input[MAX_INTERFACE_COMPONENTS / 4];
+	unsigned int robustnessSize[MAX_INTERFACE_COMPONENTS / 4];
+	unsigned int stride[MAX_INTERFACE_COMPONENTS / 4];
+
+	int instanceID;
+	int baseVertex;
+	int layer;
+
+	float WxF;
+	float HxF;
+	float X0xF;
+	float Y0xF;
+	float guardBandX;
+	float guardBandY;
+
+	vk::Pipeline::PushConstantStorage pushConstants;
+};
+
 struct DrawCall
 {
 	struct BatchData
@@ -121,6 +227,7 @@ struct DrawCall
 		TriangleBatch triangles;
 		PrimitiveBatch primitives;
 		VertexTask vertexTask;
+		VertexTask positionTask;  // Separate cache, since position-only vertices lack varyings
 		unsigned int id;
 		unsigned int firstPrimitive;
 		unsigned int numPrimitives;
@@ -142,6 +249,7 @@ struct DrawCall
 	void teardown(vk::Device *device);
 
 	int id;
+	int vertexCacheId;  // Identifies the vertex cache contents, shared by draws shading the same vertices
 
 	BatchData::Pool *batchDataPool;
 	unsigned int numPrimitives;
@@ -157,6 +265,7 @@ struct DrawCall
 	bool depthClipNegativeOneToOne;
 
 	VertexProcessor::RoutineType vertexRoutine;
+	VertexProcessor::RoutineType positionRoutine;  // Shades positions only, to cull triangles before full vertex shading
 	SetupProcessor::RoutineType setupRoutine;
 	PixelProcessor::RoutineType pixelRoutine;
 	bool preRasterizationContainsImageWrite;
@@ -174,6 +283,8 @@ struct DrawCall
 	sw::CountedEvent *events;
 
 	vk::Query *occlusionQuery;
+	bool occlusionOnly;                  // The draw only affects an imprecise occlusion query
+	std::atomic<bool> occlusionVisible;  // A sample passed, so remaining occlusion-only work can be skipped
 
 	DrawData *data;
 
@@ -192,6 +303,7 @@ struct DrawCall
 	static int setupLines(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count);
 	static int setupPoints(vk::Device *device, Triangle *triangles, Primitive *primitives, const DrawCall *drawCall, int count);
 
+	static bool isTriangleCulled(const Triangle &triangle, const DrawCall &draw);
 	static bool setupLine(vk::Device *device, Primitive &primitive, Triangle &triangle, const DrawCall &draw);
 	static bool setupPoint(vk::Device *device, Primitive &primitive, Triangle &triangle, const DrawCall &draw);
 };
@@ -217,7 +329,16 @@ public:
 
 	void synchronize();
 
+	// Draws only reuse the vertices shaded by earlier draws as long as the memory they read
+	// can't have been made visible to them, which takes synchronization or a new submission.
+	void invalidateVertexResults();
+
 private:
+	void specializeForPushConstants(const vk::GraphicsPipeline *pipeline, const vk::GraphicsState &pipelineState,
+	                                const vk::Pipeline::PushConstantStorage &pushConstants,
+	                                VertexProcessor::RoutineType &drawVertexRoutine, PixelProcessor::RoutineType &drawPixelRoutine);
+	int findVertexCacheId(const vk::GraphicsPipeline *pipeline, const DrawCall *draw);
+
 	DrawCall::Pool drawCallPool;
 	DrawCall::BatchData::Pool batchDataPool;
 
@@ -236,8 +357,28 @@ private:
 	PixelProcessor::State pixelState;
 
 	VertexProcessor::RoutineType vertexRoutine;
+	VertexProcessor::RoutineType positionRoutine;
 	SetupProcessor::RoutineType setupRoutine;
 	PixelProcessor::RoutineType pixelRoutine;
+	std::shared_ptr<ResolvedRoutines> resolvedRoutines;
+
+	const int guardBandSize;
+	const uint32_t pushConstantSpecializationDraws;
+	const bool vertexResultReuse;
+
+	struct VertexResults
+	{
+		VertexResultKey key;
+		int vertexCacheId;
+
+		// Holding on to the routines keeps their entry points in the key from being
+		// reused by other routines.
+		VertexProcessor::RoutineType vertexRoutine;
+		VertexProcessor::RoutineType positionRoutine;
+	};
+
+	// Recent draws and the vertex cache identifiers they used, oldest first.
+	std::vector<VertexResults> vertexResults;
 
 	vk::Device *device;
 };
@@ -21,6 +21,7 @@
 #include "Pipeline/SetupRoutine.hpp"
 #include "Pipeline/SpirvShader.hpp"
 #include "System/Debug.hpp"
+#include "System/Math.hpp"
 #include "Vulkan/VkImageView.hpp"
 
 #include <cstring>
@@ -29,15 +30,9 @@ namespace sw {
 
 uint32_t SetupProcessor::States::computeHash()
 {
-	uint32_t *state = reinterpret_cast<uint32_t *>(this);
-	uint32_t hash = 0;
+	uint64_t hash = FNV_1a(reinterpret_cast<const unsigned char *>(this), sizeof(States));
 
-	for(unsigned int i = 0; i < sizeof(States) / sizeof(uint32_t); i++)
-	{
-		hash ^= state[i];
-	}
-
-	return hash;
+	return static_cast<uint32_t>(hash ^ (hash >> 32));
 }
 
 bool SetupProcessor::State::operator==(const State &state) const
@@ -34,15 +34,10 @@ void VertexCache::clear()
 
 uint32_t VertexProcessor::States::computeHash()
 {
-	uint32_t *state = reinterpret_cast<uint32_t *>(this);
-	uint32_t hash = 0;
+	// An XOR fold of the words would cancel out equal fields and make similar states collide.
+	uint64_t hash = FNV_1a(reinterpret_cast<const unsigned char *>(this), sizeof(States));
 
-	for(unsigned int i = 0; i < sizeof(States) / sizeof(uint32_t); i++)
-	{
-		hash ^= state[i];
-	}
-
-	return hash;
+	return static_cast<uint32_t>(hash ^ (hash >> 32));
 }
 
 bool VertexProcessor::State::operator==(const State &state) const
@@ -52,7 +47,24 @@ bool VertexProcessor::State::operator==(const State &state) const
 		return false;
 	}
 
-	return *static_cast<const States *>(this) == static_cast<const States &>(state);
+	if(!(*static_cast<const States *>(this) == static_cast<const States &>(state)))
+	{
+		return false;
+	}
+
+	return !specializedPushConstants || (memcmp(pushConstants, state.pushConstants, sizeof(pushConstants)) == 0);
+}
+
+void VertexProcessor::State::specializeForPushConstants(const uint8_t *data, uint32_t begin, uint32_t end)
+{
+	// Bytes outside of the pipeline layouts' ranges may be left over from other
+	// pipelines, so they're cleared to not distinguish otherwise equal states.
+	memset(pushConstants, 0, sizeof(pushConstants));
+	memcpy(&pushConstants[begin], &data[begin], end - begin);
+
+	specializedPushConstants = true;
+	pushConstantsHash = static_cast<uint32_t>(FNV_1a(pushConstants, sizeof(pushConstants)));
+	hash = computeHash();
 }
 
 VertexProcessor::VertexProcessor()
@@ -65,7 +77,7 @@ void VertexProcessor::setRoutineCacheSize(int cacheSize)
 	routineCache = std::make_unique<RoutineCacheType>(clamp(cacheSize, 1, 65536));
 }
 
-const VertexProcessor::State VertexProcessor::update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *vertexShader, const vk::Inputs &inputs)
+const VertexProcessor::State VertexProcessor::update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *vertexShader, const vk::Inputs &inputs, bool positionOnly)
 {
 	const vk::VertexInputInterfaceState &vertexInputInterfaceState = pipelineState.getVertexInputInterfaceState();
 	const vk::PreRasterizationState &preRasterizationState = pipelineState.getPreRasterizationState();
@@ -78,6 +90,7 @@ const VertexProcessor::State VertexProcessor::update(const vk::GraphicsState &pi
 	state.isPoint = vertexInputInterfaceState.getTopology() == VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
 	state.depthClipEnable = preRasterizationState.getDepthClipEnable();
 	state.depthClipNegativeOneToOne = preRasterizationState.getDepthClipNegativeOneToOne();
+	state.positionOnly = positionOnly;
 
 	for(size_t i = 0; i < MAX_INTERFACE_COMPONENTS / 4; i++)
 	{
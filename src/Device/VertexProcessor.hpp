@@ -83,20 +83,31 @@ public:
 		bool isPoint : 1;
 		bool depthClipEnable : 1;
 		bool depthClipNegativeOneToOne : 1;
+		bool positionOnly : 1;  // Varyings are not consumed
+		bool specializedPushConstants : 1;
+
+		uint32_t pushConstantsHash;  // Digest of pushConstants, zero when not specialized
 	};
 
 	struct State : States
 	{
 		bool operator==(const State &state) const;
 
+		void specializeForPushConstants(const uint8_t *data, uint32_t begin, uint32_t end);
+
 		uint32_t hash;
+
+		// Push constant values which the routine is specialized for. Left
+		// uninitialized, and excluded from hashing and comparison, unless
+		// specializedPushConstants is set.
+		uint8_t pushConstants[vk::MAX_PUSH_CONSTANT_SIZE];
 	};
 
 	using RoutineType = VertexRoutineFunction::RoutineType;
 
 	VertexProcessor();
 
-	const State update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *vertexShader, const vk::Inputs &inputs);
+	const State update(const vk::GraphicsState &pipelineState, const sw::SpirvShader *vertexShader, const vk::Inputs &inputs, bool positionOnly);
 	RoutineType routine(const State &state, const vk::PipelineLayout *pipelineLayout,
 	                    const SpirvShader *vertexShader, const vk::DescriptorSet::Bindings &descriptorSets);
 
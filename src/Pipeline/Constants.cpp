@@ -273,6 +273,7 @@ Constants::Constants()
 	for(int i = 0; i < 256; i++)
 	{
 		sRGBtoLinearFF_FF00[i] = (unsigned short)(sRGBtoLinear((float)i / 0xFF) * 0xFF00 + 0.5f);
+		sRGBtoLinearFF_F[i] = sRGBtoLinear((float)i / 0xFF);
 	}
 
 	for(int q = 0; q < 4; q++)
@@ -107,6 +107,7 @@ struct Constants
 	dword4 mask11X[8];        // 3 bit writemask -> B10G11R11 bit patterns, replicated 4x
 
 	unsigned short sRGBtoLinearFF_FF00[256];
+	float sRGBtoLinearFF_F[256];  // 8-bit sRGB -> normalized linear float
 
 	// Centroid parameters
 	float4 sampleX[4][16];
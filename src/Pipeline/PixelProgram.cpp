@@ -196,6 +196,14 @@ void PixelProgram::executeShader(Int cMask[4], Int sMask[4], Int zMask[4], const
 	// handled separately, through the cMask.
 	SIMD::Int activeLaneMask = 0xFFFFFFFF;
 	SIMD::Int storesAndAtomicsMask = maskAny(cMask, sMask, zMask, samples);
+
+	// Helper invocations are unobservable in shaders which don't access neighboring lanes,
+	// so only shade covered fragments. This allows loops and divergent branches to
+	// terminate as soon as the covered lanes are done, instead of waiting for helpers.
+	if(!spirvShader->getAnalysis().ContainsDerivatives)
+	{
+		activeLaneMask = storesAndAtomicsMask;
+	}
 	routine.discardMask = 0;
 
 	spirvShader->emit(&routine, activeLaneMask, storesAndAtomicsMask, descriptorSets, &attachments, state.multiSampleCount);
@@ -267,6 +275,27 @@ void PixelProgram::blendColor(Pointer<Byte> cBuffer[4], Int &x, Int sMask[4], In
 			continue;
 		}
 
+		if(state.fixedPointBlend(index))
+		{
+			ASSERT(SIMD::Width == 4);
+			Vector4s current;
+			current.x = Short4(RoundInt(Extract128(c[index].x, 0) * 0xFFFF));
+			current.y = Short4(RoundInt(Extract128(c[index].y, 0) * 0xFFFF));
+			current.z = Short4(RoundInt(Extract128(c[index].z, 0) * 0xFFFF));
+			current.w = Short4(RoundInt(Extract128(c[index].w, 0) * 0xFFFF));
+
+			for(unsigned int q : samples)
+			{
+				Pointer<Byte> buffer = cBuffer[index] + q * *Pointer<Int>(data + OFFSET(DrawData, colorSliceB[index]));
+
+				Vector4s color = current;
+				alphaBlend(index, buffer, color, x);
+				writeColor(index, buffer, x, color, sMask[q], zMask[q], cMask[q]);
+			}
+
+			continue;
+		}
+
 		for(unsigned int q : samples)
 		{
 			Pointer<Byte> buffer = cBuffer[index] + q * *Pointer<Int>(data + OFFSET(DrawData, colorSliceB[index]));
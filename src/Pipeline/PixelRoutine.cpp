@@ -66,6 +66,11 @@ PixelRoutine::PixelRoutine(
     , perSampleShading(shouldUsePerSampleShading(state, spirvShader))
     , invocationCount(perSampleShading ? state.multiSampleCount : 1)
 {
+	if(state.specializedPushConstants)
+	{
+		routine.specializedPushConstants = state.pushConstants;
+	}
+
 	if(spirvShader)
 	{
 		spirvShader->emitProlog(&routine);
@@ -193,14 +198,27 @@ void PixelRoutine::quad(Pointer<Byte> cBuffer[MAX_COLOR_BUFFERS], Pointer<Byte>
 				yCentroid += yFragment;
 			}
 
+			// Primitives with constant w have their perspective-correct plane equations
+			// pre-multiplied by w during setup, so they don't need perspective division.
+			Bool affine = *Pointer<Int>(primitive + OFFSET(Primitive, affine)) != 0;
+
 			if(interpolateW())
 			{
 				w = interpolate(xFragment, Dw, rhw, primitive + OFFSET(Primitive, w), false, false);
-				rhw = reciprocal(w, false, true);
 
-				if(state.centroid || shaderContainsInterpolation)  // TODO(b/194714095)
+				If(affine)
 				{
-					rhwCentroid = reciprocal(SpirvRoutine::interpolateAtXY(xCentroid, yCentroid, rhwCentroid, primitive + OFFSET(Primitive, w), SpirvRoutine::Linear));
+					rhw = SIMD::Float(1.0f);
+					rhwCentroid = SIMD::Float(1.0f);
+				}
+				Else
+				{
+					rhw = reciprocal(w, false, true);
+
+					if(state.centroid || shaderContainsInterpolation)  // TODO(b/194714095)
+					{
+						rhwCentroid = reciprocal(SpirvRoutine::interpolateAtXY(xCentroid, yCentroid, rhwCentroid, primitive + OFFSET(Primitive, w), SpirvRoutine::Linear));
+					}
 				}
 			}
 
@@ -228,36 +246,55 @@ void PixelRoutine::quad(Pointer<Byte> cBuffer[MAX_COLOR_BUFFERS], Pointer<Byte>
 					ySample += SampleLocationsY[samples[0]];
 				}
 
-				int packedInterpolant = 0;
-				for(int interfaceInterpolant = 0; interfaceInterpolant < MAX_INTERFACE_COMPONENTS; interfaceInterpolant++)
-				{
-					const auto &input = spirvShader->inputs[interfaceInterpolant];
-					if(input.Type != Spirv::ATTRIBTYPE_UNUSED)
+				auto interpolateInputs = [&](bool perspectiveDivide) {
+					int packedInterpolant = 0;
+					for(int interfaceInterpolant = 0; interfaceInterpolant < MAX_INTERFACE_COMPONENTS; interfaceInterpolant++)
 					{
-						routine.inputsInterpolation[packedInterpolant] = input.Flat ? SpirvRoutine::Flat : (input.NoPerspective ? SpirvRoutine::Linear : SpirvRoutine::Perspective);
-						if(input.Centroid && state.enableMultiSampling)
-						{
-							routine.inputs[interfaceInterpolant] =
-							    SpirvRoutine::interpolateAtXY(xCentroid, yCentroid, rhwCentroid,
-							                                  primitive + OFFSET(Primitive, V[packedInterpolant]),
-							                                  routine.inputsInterpolation[packedInterpolant]);
-						}
-						else if(perSampleShading)
-						{
-							routine.inputs[interfaceInterpolant] =
-							    SpirvRoutine::interpolateAtXY(xSample, ySample, rhw,
-							                                  primitive + OFFSET(Primitive, V[packedInterpolant]),
-							                                  routine.inputsInterpolation[packedInterpolant]);
-						}
-						else
+						const auto &input = spirvShader->inputs[interfaceInterpolant];
+						if(input.Type != Spirv::ATTRIBTYPE_UNUSED)
 						{
-							routine.inputs[interfaceInterpolant] =
-							    interpolate(xFragment, Dv[interfaceInterpolant], rhw,
-							                primitive + OFFSET(Primitive, V[packedInterpolant]),
-							                input.Flat, !input.NoPerspective);
+							routine.inputsInterpolation[packedInterpolant] = input.Flat ? SpirvRoutine::Flat : (input.NoPerspective ? SpirvRoutine::Linear : SpirvRoutine::Perspective);
+							auto interpolation = (perspectiveDivide || input.Flat) ? routine.inputsInterpolation[packedInterpolant] : SpirvRoutine::Linear;
+							if(input.Centroid && state.enableMultiSampling)
+							{
+								routine.inputs[interfaceInterpolant] =
+								    SpirvRoutine::interpolateAtXY(xCentroid, yCentroid, rhwCentroid,
+								                                  primitive + OFFSET(Primitive, V[packedInterpolant]),
+								                                  interpolation);
+							}
+							else if(perSampleShading)
+							{
+								routine.inputs[interfaceInterpolant] =
+								    SpirvRoutine::interpolateAtXY(xSample, ySample, rhw,
+								                                  primitive + OFFSET(Primitive, V[packedInterpolant]),
+								                                  interpolation);
+							}
+							else
+							{
+								routine.inputs[interfaceInterpolant] =
+								    interpolate(xFragment, Dv[interfaceInterpolant], rhw,
+								                primitive + OFFSET(Primitive, V[packedInterpolant]),
+								                input.Flat, perspectiveDivide && !input.NoPerspective);
+							}
+							packedInterpolant++;
 						}
-						packedInterpolant++;
 					}
+				};
+
+				if(interpolateW())
+				{
+					If(affine)
+					{
+						interpolateInputs(false);
+					}
+					Else
+					{
+						interpolateInputs(true);
+					}
+				}
+				else
+				{
+					interpolateInputs(true);
 				}
 
 				setBuiltins(x, y, unclampedZ, w, cMask, samples);
@@ -745,6 +782,17 @@ void PixelRoutine::occlusionSampleCount(const Int zMask[4], const Int sMask[4],
 		return;
 	}
 
+	if(!state.occlusionPrecise)
+	{
+		// Any nonzero value satisfies an imprecise query, so accumulate the coverage masks instead of counting samples
+		for(unsigned int q : samples)
+		{
+			occlusion |= As<UInt>(zMask[q] & sMask[q]);
+		}
+
+		return;
+	}
+
 	for(unsigned int q : samples)
 	{
 		occlusion += *Pointer<UInt>(constants + OFFSET(Constants, occlusionCount) + 4 * (zMask[q] & sMask[q]));
@@ -1814,17 +1862,22 @@ SIMD::Float4 PixelRoutine::alphaBlend(int index, const Pointer<Byte> &cBuffer, c
 			// Attempt to read an integer based format and convert it to float
 			Vector4s color;
 			readPixel(index, cBuffer, x, color);
-			texelColor.x = Float4(As<UShort4>(color.x)) * (1.0f / 0xFFFF);
-			texelColor.y = Float4(As<UShort4>(color.y)) * (1.0f / 0xFFFF);
-			texelColor.z = Float4(As<UShort4>(color.z)) * (1.0f / 0xFFFF);
-			texelColor.w = Float4(As<UShort4>(color.w)) * (1.0f / 0xFFFF);
 
 			if(isSRGB(index))
 			{
-				texelColor.x = sRGBtoLinear(texelColor.x);
-				texelColor.y = sRGBtoLinear(texelColor.y);
-				texelColor.z = sRGBtoLinear(texelColor.z);
+				// sRGB formats are 8-bit, so decode them using a lookup table
+				texelColor.x = sRGB8toLinear(Int4(As<UShort4>(color.x) >> 8), constants);
+				texelColor.y = sRGB8toLinear(Int4(As<UShort4>(color.y) >> 8), constants);
+				texelColor.z = sRGB8toLinear(Int4(As<UShort4>(color.z) >> 8), constants);
+			}
+			else
+			{
+				texelColor.x = Float4(As<UShort4>(color.x)) * (1.0f / 0xFFFF);
+				texelColor.y = Float4(As<UShort4>(color.y)) * (1.0f / 0xFFFF);
+				texelColor.z = Float4(As<UShort4>(color.z)) * (1.0f / 0xFFFF);
 			}
+
+			texelColor.w = Float4(As<UShort4>(color.w)) * (1.0f / 0xFFFF);
 		}
 		break;
 	}
@@ -1960,6 +2013,168 @@ SIMD::Float4 PixelRoutine::alphaBlend(int index, const Pointer<Byte> &cBuffer, c
 	return blendedColor;
 }
 
+void PixelRoutine::blendFactorRGB(Vector4s &blendFactor, const Vector4s &current, const Vector4s &pixel, VkBlendFactor colorBlendFactor)
+{
+	switch(colorBlendFactor)
+	{
+	case VK_BLEND_FACTOR_ZERO:
+	case VK_BLEND_FACTOR_ONE:
+		// Handled by blendOperation()
+		break;
+	case VK_BLEND_FACTOR_SRC_COLOR:
+		blendFactor.x = current.x;
+		blendFactor.y = current.y;
+		blendFactor.z = current.z;
+		break;
+	case VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR:
+		blendFactor.x = ~current.x;
+		blendFactor.y = ~current.y;
+		blendFactor.z = ~current.z;
+		break;
+	case VK_BLEND_FACTOR_DST_COLOR:
+		blendFactor.x = pixel.x;
+		blendFactor.y = pixel.y;
+		blendFactor.z = pixel.z;
+		break;
+	case VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR:
+		blendFactor.x = ~pixel.x;
+		blendFactor.y = ~pixel.y;
+		blendFactor.z = ~pixel.z;
+		break;
+	case VK_BLEND_FACTOR_SRC_ALPHA:
+		blendFactor.x = current.w;
+		blendFactor.y = current.w;
+		blendFactor.z = current.w;
+		break;
+	case VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA:
+		blendFactor.x = ~current.w;
+		blendFactor.y = ~current.w;
+		blendFactor.z = ~current.w;
+		break;
+	case VK_BLEND_FACTOR_DST_ALPHA:
+		blendFactor.x = pixel.w;
+		blendFactor.y = pixel.w;
+		blendFactor.z = pixel.w;
+		break;
+	case VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA:
+		blendFactor.x = ~pixel.w;
+		blendFactor.y = ~pixel.w;
+		blendFactor.z = ~pixel.w;
+		break;
+	case VK_BLEND_FACTOR_SRC_ALPHA_SATURATE:
+		blendFactor.x = As<Short4>(Min(As<UShort4>(current.w), As<UShort4>(~pixel.w)));
+		blendFactor.y = blendFactor.x;
+		blendFactor.z = blendFactor.x;
+		break;
+	default:
+		UNSUPPORTED("VkBlendFactor: %d", int(colorBlendFactor));
+	}
+}
+
+void PixelRoutine::blendFactorAlpha(Short4 &blendFactorAlpha, const Short4 &current, const Short4 &pixel, VkBlendFactor alphaBlendFactor)
+{
+	switch(alphaBlendFactor)
+	{
+	case VK_BLEND_FACTOR_ZERO:
+	case VK_BLEND_FACTOR_ONE:
+	case VK_BLEND_FACTOR_SRC_ALPHA_SATURATE:
+		// Handled by blendOperation()
+		break;
+	case VK_BLEND_FACTOR_SRC_COLOR:
+	case VK_BLEND_FACTOR_SRC_ALPHA:
+		blendFactorAlpha = current;
+		break;
+	case VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR:
+	case VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA:
+		blendFactorAlpha = ~current;
+		break;
+	case VK_BLEND_FACTOR_DST_COLOR:
+	case VK_BLEND_FACTOR_DST_ALPHA:
+		blendFactorAlpha = pixel;
+		break;
+	case VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR:
+	case VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA:
+		blendFactorAlpha = ~pixel;
+		break;
+	default:
+		UNSUPPORTED("VkBlendFactor: %d", int(alphaBlendFactor));
+	}
+}
+
+Short4 PixelRoutine::blendOperation(const Short4 &current, const Short4 &pixel, const Short4 &sourceFactor, const Short4 &destFactor,
+                                    VkBlendFactor sourceBlendFactor, VkBlendFactor destBlendFactor, VkBlendOp blendOperation)
+{
+	// MulHigh() computes x * y / 0x10000 instead of x * y / 0xFFFF. The error stays below one
+	// 16-bit step, which the rounding to 8-bit in writeColor() absorbs.
+	auto multiply = [](const Short4 &color, const Short4 &factor, VkBlendFactor blendFactor) -> Short4 {
+		switch(blendFactor)
+		{
+		case VK_BLEND_FACTOR_ZERO:
+			return Short4(0x0000);
+		case VK_BLEND_FACTOR_ONE:
+			return color;
+		default:
+			return As<Short4>(MulHigh(As<UShort4>(color), As<UShort4>(factor)));
+		}
+	};
+
+	// Blend factors which are treated as one for the alpha channel.
+	if(sourceBlendFactor == VK_BLEND_FACTOR_SRC_ALPHA_SATURATE) sourceBlendFactor = VK_BLEND_FACTOR_ONE;
+	if(destBlendFactor == VK_BLEND_FACTOR_SRC_ALPHA_SATURATE) destBlendFactor = VK_BLEND_FACTOR_ONE;
+
+	switch(blendOperation)
+	{
+	case VK_BLEND_OP_ADD:
+		return As<Short4>(AddSat(As<UShort4>(multiply(current, sourceFactor, sourceBlendFactor)),
+		                         As<UShort4>(multiply(pixel, destFactor, destBlendFactor))));
+	case VK_BLEND_OP_SUBTRACT:
+		return As<Short4>(SubSat(As<UShort4>(multiply(current, sourceFactor, sourceBlendFactor)),
+		                         As<UShort4>(multiply(pixel, destFactor, destBlendFactor))));
+	case VK_BLEND_OP_REVERSE_SUBTRACT:
+		return As<Short4>(SubSat(As<UShort4>(multiply(pixel, destFactor, destBlendFactor)),
+		                         As<UShort4>(multiply(current, sourceFactor, sourceBlendFactor))));
+	case VK_BLEND_OP_MIN:
+		return As<Short4>(Min(As<UShort4>(current), As<UShort4>(pixel)));
+	case VK_BLEND_OP_MAX:
+		return As<Short4>(Max(As<UShort4>(current), As<UShort4>(pixel)));
+	default:
+		UNSUPPORTED("VkBlendOp: %d", int(blendOperation));
+		return current;
+	}
+}
+
+void PixelRoutine::alphaBlend(int index, const Pointer<Byte> &cBuffer, Vector4s &current, const Int &x)
+{
+	ASSERT(state.fixedPointBlend(index));
+
+	const vk::BlendState &blendState = state.blendState[index];
+
+	Vector4s pixel;
+	readPixel(index, cBuffer, x, pixel);
+
+	Vector4s sourceFactor;
+	Vector4s destFactor;
+
+	blendFactorRGB(sourceFactor, current, pixel, blendState.sourceBlendFactor);
+	blendFactorRGB(destFactor, current, pixel, blendState.destBlendFactor);
+	blendFactorAlpha(sourceFactor.w, current.w, pixel.w, blendState.sourceBlendFactorAlpha);
+	blendFactorAlpha(destFactor.w, current.w, pixel.w, blendState.destBlendFactorAlpha);
+
+	// SRC_ALPHA_SATURATE is only a constant one for the alpha channel.
+	VkBlendFactor sourceBlendFactor = blendState.sourceBlendFactor;
+	VkBlendFactor destBlendFactor = blendState.destBlendFactor;
+	if(sourceBlendFactor == VK_BLEND_FACTOR_SRC_ALPHA_SATURATE) sourceBlendFactor = VK_BLEND_FACTOR_SRC_COLOR;
+	if(destBlendFactor == VK_BLEND_FACTOR_SRC_ALPHA_SATURATE) destBlendFactor = VK_BLEND_FACTOR_SRC_COLOR;
+
+	Vector4s blended;
+	blended.x = blendOperation(current.x, pixel.x, sourceFactor.x, destFactor.x, sourceBlendFactor, destBlendFactor, blendState.blendOperation);
+	blended.y = blendOperation(current.y, pixel.y, sourceFactor.y, destFactor.y, sourceBlendFactor, destBlendFactor, blendState.blendOperation);
+	blended.z = blendOperation(current.z, pixel.z, sourceFactor.z, destFactor.z, sourceBlendFactor, destBlendFactor, blendState.blendOperation);
+	blended.w = blendOperation(current.w, pixel.w, sourceFactor.w, destFactor.w, blendState.sourceBlendFactorAlpha, blendState.destBlendFactorAlpha, blendState.blendOperationAlpha);
+
+	current = blended;
+}
+
 void PixelRoutine::writeColor(int index, const Pointer<Byte> &cBuffer, const Int &x, Vector4f &color, const Int &sMask, const Int &zMask, const Int &cMask)
 {
 	if(isSRGB(index))
@@ -2935,4 +3150,80 @@ void PixelRoutine::writeColor(int index, const Pointer<Byte> &cBuffer, const Int
 	}
 }
 
+void PixelRoutine::writeColor(int index, const Pointer<Byte> &cBuffer, const Int &x, Vector4s &color, const Int &sMask, const Int &zMask, const Int &cMask)
+{
+	vk::Format format = state.colorFormat[index];
+	ASSERT(format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_B8G8R8A8_UNORM);
+
+	int writeMask = state.colorWriteActive(index);
+	if((writeMask & 0x0000000F) == 0x0)
+	{
+		return;
+	}
+
+	// Round to 8-bit, using x / 0xFFFF * 0xFF == (x - x / 0x100) / 0x100
+	auto unorm8 = [](const Short4 &c) -> Short4 {
+		UShort4 u = As<UShort4>(c);
+		return As<Short4>((u - (u >> 8) + UShort4(0x0080)) >> 8);
+	};
+
+	Short4 r = unorm8(color.x);
+	Short4 g = unorm8(color.y);
+	Short4 b = unorm8(color.z);
+	Short4 a = unorm8(color.w);
+
+	if(format.isBGRformat())
+	{
+		std::swap(r, b);
+
+		// For BGR formats, flip R and B channels in the channels mask
+		writeMask = (writeMask & 0x0000000A) | (writeMask & 0x00000001) << 2 | (writeMask & 0x00000004) >> 2;
+	}
+
+	// Interleave the channels of each pixel
+	Int2 rg01 = UnpackLow(r, g);
+	Int2 rg23 = UnpackHigh(r, g);
+	Int2 ba01 = UnpackLow(b, a);
+	Int2 ba23 = UnpackHigh(b, a);
+
+	Int xMask;  // Combination of all masks
+
+	if(state.depthTestActive)
+	{
+		xMask = zMask;
+	}
+	else
+	{
+		xMask = cMask;
+	}
+
+	if(state.stencilActive)
+	{
+		xMask &= sMask;
+	}
+
+	Pointer<Byte> buffer = cBuffer + 4 * x;
+	Int pitchB = *Pointer<Int>(data + OFFSET(DrawData, colorPitchB[index]));
+
+	UInt2 packedCol = As<UInt2>(PackUnsigned(UnpackLow(rg01, ba01), UnpackHigh(rg01, ba01)));
+	UInt2 value = *Pointer<UInt2>(buffer, 16);
+	UInt2 mergedMask = *Pointer<UInt2>(constants + OFFSET(Constants, maskD01Q) + xMask * 8);
+	if(writeMask != 0xF)
+	{
+		mergedMask &= *Pointer<UInt2>(constants + OFFSET(Constants, maskB4Q[writeMask]));
+	}
+	*Pointer<UInt2>(buffer) = (packedCol & mergedMask) | (value & ~mergedMask);
+
+	buffer += pitchB;
+
+	packedCol = As<UInt2>(PackUnsigned(UnpackLow(rg23, ba23), UnpackHigh(rg23, ba23)));
+	value = *Pointer<UInt2>(buffer, 16);
+	mergedMask = *Pointer<UInt2>(constants + OFFSET(Constants, maskD23Q) + xMask * 8);
+	if(writeMask != 0xF)
+	{
+		mergedMask &= *Pointer<UInt2>(constants + OFFSET(Constants, maskB4Q[writeMask]));
+	}
+	*Pointer<UInt2>(buffer) = (packedCol & mergedMask) | (value & ~mergedMask);
+}
+
 }  // namespace sw
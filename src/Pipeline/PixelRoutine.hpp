@@ -59,6 +59,11 @@ protected:
 	void writeColor(int index, const Pointer<Byte> &cBuffer, const Int &x, Vector4f &color, const Int &sMask, const Int &zMask, const Int &cMask);
 	SIMD::Float4 alphaBlend(int index, const Pointer<Byte> &cBuffer, const SIMD::Float4 &sourceColor, const Int &x);
 
+	// Fixed-point blending, for attachments where state.fixedPointBlend(index) is true.
+	// Colors are represented as 16-bit unsigned normalized values.
+	void writeColor(int index, const Pointer<Byte> &cBuffer, const Int &x, Vector4s &color, const Int &sMask, const Int &zMask, const Int &cMask);
+	void alphaBlend(int index, const Pointer<Byte> &cBuffer, Vector4s &current, const Int &x);
+
 	bool isSRGB(int index) const;
 
 private:
@@ -81,6 +86,10 @@ private:
 	Float blendConstant(vk::Format format, int component, BlendFactorModifier modifier = None);
 	void blendFactorRGB(SIMD::Float4 &blendFactorRGB, const SIMD::Float4 &sourceColor, const SIMD::Float4 &destColor, VkBlendFactor colorBlendFactor, vk::Format format);
 	void blendFactorAlpha(SIMD::Float &blendFactorAlpha, const SIMD::Float &sourceAlpha, const SIMD::Float &destAlpha, VkBlendFactor alphaBlendFactor, vk::Format format);
+	void blendFactorRGB(Vector4s &blendFactor, const Vector4s &current, const Vector4s &pixel, VkBlendFactor colorBlendFactor);
+	void blendFactorAlpha(Short4 &blendFactorAlpha, const Short4 &current, const Short4 &pixel, VkBlendFactor alphaBlendFactor);
+	Short4 blendOperation(const Short4 &current, const Short4 &pixel, const Short4 &sourceFactor, const Short4 &destFactor,
+	                      VkBlendFactor sourceBlendFactor, VkBlendFactor destBlendFactor, VkBlendOp blendOperation);
 
 	bool blendFactorCanExceedFormatRange(VkBlendFactor blendFactor, vk::Format format);
 	SIMD::Float4 computeAdvancedBlendMode(int index, const SIMD::Float4 &src, const SIMD::Float4 &dst, const SIMD::Float4 &srcFactor, const SIMD::Float4 &dstFactor);
@@ -323,59 +323,74 @@ Vector4s SamplerCore::sampleFilter(Pointer<Byte> &texture, Float4 &u, Float4 &v,
 
 	if(state.mipmapFilter == MIPMAP_LINEAR)
 	{
-		Vector4s cc = sampleAniso(texture, u, v, w, a, offset, sample, lod, anisotropy, uDelta, vDelta, true);
+		auto blendSecondLOD = [&]() {
+			Vector4s cc = sampleAniso(texture, u, v, w, a, offset, sample, lod, anisotropy, uDelta, vDelta, true);
 
-		lod *= Float(1 << 16);
+			lod *= Float(1 << 16);
 
-		UShort4 utri = UShort4(Float4(lod));  // TODO: Optimize
-		Short4 stri = utri >> 1;              // TODO: Optimize
+			UShort4 utri = UShort4(Float4(lod));  // TODO: Optimize
+			Short4 stri = utri >> 1;              // TODO: Optimize
 
-		if(hasUnsignedTextureComponent(0))
-			cc.x = MulHigh(As<UShort4>(cc.x), utri);
-		else
-			cc.x = MulHigh(cc.x, stri);
-		if(hasUnsignedTextureComponent(1))
-			cc.y = MulHigh(As<UShort4>(cc.y), utri);
-		else
-			cc.y = MulHigh(cc.y, stri);
-		if(hasUnsignedTextureComponent(2))
-			cc.z = MulHigh(As<UShort4>(cc.z), utri);
-		else
-			cc.z = MulHigh(cc.z, stri);
-		if(hasUnsignedTextureComponent(3))
-			cc.w = MulHigh(As<UShort4>(cc.w), utri);
-		else
-			cc.w = MulHigh(cc.w, stri);
+			if(hasUnsignedTextureComponent(0))
+				cc.x = MulHigh(As<UShort4>(cc.x), utri);
+			else
+				cc.x = MulHigh(cc.x, stri);
+			if(hasUnsignedTextureComponent(1))
+				cc.y = MulHigh(As<UShort4>(cc.y), utri);
+			else
+				cc.y = MulHigh(cc.y, stri);
+			if(hasUnsignedTextureComponent(2))
+				cc.z = MulHigh(As<UShort4>(cc.z), utri);
+			else
+				cc.z = MulHigh(cc.z, stri);
+			if(hasUnsignedTextureComponent(3))
+				cc.w = MulHigh(As<UShort4>(cc.w), utri);
+			else
+				cc.w = MulHigh(cc.w, stri);
 
-		utri = ~utri;
-		stri = Short4(0x7FFF) - stri;
+			utri = ~utri;
+			stri = Short4(0x7FFF) - stri;
 
-		if(hasUnsignedTextureComponent(0))
-			c.x = MulHigh(As<UShort4>(c.x), utri);
-		else
-			c.x = MulHigh(c.x, stri);
-		if(hasUnsignedTextureComponent(1))
-			c.y = MulHigh(As<UShort4>(c.y), utri);
-		else
-			c.y = MulHigh(c.y, stri);
-		if(hasUnsignedTextureComponent(2))
-			c.z = MulHigh(As<UShort4>(c.z), utri);
-		else
-			c.z = MulHigh(c.z, stri);
-		if(hasUnsignedTextureComponent(3))
-			c.w = MulHigh(As<UShort4>(c.w), utri);
-		else
-			c.w = MulHigh(c.w, stri);
+			if(hasUnsignedTextureComponent(0))
+				c.x = MulHigh(As<UShort4>(c.x), utri);
+			else
+				c.x = MulHigh(c.x, stri);
+			if(hasUnsignedTextureComponent(1))
+				c.y = MulHigh(As<UShort4>(c.y), utri);
+			else
+				c.y = MulHigh(c.y, stri);
+			if(hasUnsignedTextureComponent(2))
+				c.z = MulHigh(As<UShort4>(c.z), utri);
+			else
+				c.z = MulHigh(c.z, stri);
+			if(hasUnsignedTextureComponent(3))
+				c.w = MulHigh(As<UShort4>(c.w), utri);
+			else
+				c.w = MulHigh(c.w, stri);
 
-		c.x += cc.x;
-		c.y += cc.y;
-		c.z += cc.z;
-		c.w += cc.w;
+			c.x += cc.x;
+			c.y += cc.y;
+			c.z += cc.z;
+			c.w += cc.w;
 
-		if(!hasUnsignedTextureComponent(0)) c.x += c.x;
-		if(!hasUnsignedTextureComponent(1)) c.y += c.y;
-		if(!hasUnsignedTextureComponent(2)) c.z += c.z;
-		if(!hasUnsignedTextureComponent(3)) c.w += c.w;
+			if(!hasUnsignedTextureComponent(0)) c.x += c.x;
+			if(!hasUnsignedTextureComponent(1)) c.y += c.y;
+			if(!hasUnsignedTextureComponent(2)) c.z += c.z;
+			if(!hasUnsignedTextureComponent(3)) c.w += c.w;
+		};
+
+		if(state.textureFilter == FILTER_ANISOTROPIC)
+		{
+			// Anisotropic taps are expensive, so skip the second level when it doesn't contribute.
+			If(Frac(lod) != 0.0f)
+			{
+				blendSecondLOD();
+			}
+		}
+		else
+		{
+			blendSecondLOD();
+		}
 	}
 
 	return c;
@@ -393,6 +408,13 @@ Vector4s SamplerCore::sampleAniso(Pointer<Byte> &texture, Float4 &u, Float4 &v,
 	{
 		Int N = RoundInt(anisotropy);
 
+		if(secondLOD)
+		{
+			// The next mipmap level has half the texel density along the major axis,
+			// so half as many taps cover the same footprint.
+			N = (N + 1) >> 1;
+		}
+
 		Vector4s cSum;
 
 		cSum.x = Short4(0);
@@ -416,6 +438,8 @@ Vector4s SamplerCore::sampleAniso(Pointer<Byte> &texture, Float4 &u, Float4 &v,
 
 		Int i = 0;
 
+		// Each tap is a bilinear sample of a single mipmap level. With trilinear filtering,
+		// sampleFilter() blends the sums of both levels once, rather than per tap.
 		Do
 		{
 			c = sampleQuad(texture, u0, v0, w, a, offset, sample, lod, secondLOD);
@@ -866,7 +890,7 @@ Vector4s SamplerCore::sampleQuad2D(Pointer<Byte> &texture, Float4 &u, Float4 &v,
 	{
 		if(state.textureFilter == FILTER_POINT)
 		{
-			c = sampleTexel(uuuu, vvvv, wwww, layerIndex, sample, mipmap, buffer);
+			c = sampleTexel(uuuu, vvvv, wwww, layerIndex, sample, mipmap, buffer, true);
 		}
 		else
 		{
@@ -875,7 +899,7 @@ Vector4s SamplerCore::sampleQuad2D(Pointer<Byte> &texture, Float4 &u, Float4 &v,
 			Short4 uuuu1 = offsetSample(uuuu, mipmap, OFFSET(Mipmap, uHalf), state.addressingModeU == ADDRESSING_WRAP, +1, lod);
 			Short4 vvvv1 = offsetSample(vvvv, mipmap, OFFSET(Mipmap, vHalf), state.addressingModeV == ADDRESSING_WRAP, +1, lod);
 
-			Vector4s c00 = sampleTexel(uuuu0, vvvv0, wwww, layerIndex, sample, mipmap, buffer);
+			Vector4s c00 = sampleTexel(uuuu0, vvvv0, wwww, layerIndex, sample, mipmap, buffer, true);
 			Vector4s c10 = sampleTexel(uuuu1, vvvv0, wwww, layerIndex, sample, mipmap, buffer);
 			Vector4s c01 = sampleTexel(uuuu0, vvvv1, wwww, layerIndex, sample, mipmap, buffer);
 			Vector4s c11 = sampleTexel(uuuu1, vvvv1, wwww, layerIndex, sample, mipmap, buffer);
@@ -1068,14 +1092,29 @@ Vector4f SamplerCore::sampleFloatFilter(Pointer<Byte> &texture, Float4 &u, Float
 
 	if(state.mipmapFilter == MIPMAP_LINEAR)
 	{
-		Vector4f cc = sampleFloatAniso(texture, u, v, w, a, dRef, offset, sample, lod, anisotropy, uDelta, vDelta, true);
+		auto blendSecondLOD = [&]() {
+			Vector4f cc = sampleFloatAniso(texture, u, v, w, a, dRef, offset, sample, lod, anisotropy, uDelta, vDelta, true);
 
-		Float4 lod4 = Float4(Frac(lod));
+			Float4 lod4 = Float4(Frac(lod));
 
-		c.x = (cc.x - c.x) * lod4 + c.x;
-		c.y = (cc.y - c.y) * lod4 + c.y;
-		c.z = (cc.z - c.z) * lod4 + c.z;
-		c.w = (cc.w - c.w) * lod4 + c.w;
+			c.x = (cc.x - c.x) * lod4 + c.x;
+			c.y = (cc.y - c.y) * lod4 + c.y;
+			c.z = (cc.z - c.z) * lod4 + c.z;
+			c.w = (cc.w - c.w) * lod4 + c.w;
+		};
+
+		if(state.textureFilter == FILTER_ANISOTROPIC)
+		{
+			// Anisotropic taps are expensive, so skip the second level when it doesn't contribute.
+			If(Frac(lod) != 0.0f)
+			{
+				blendSecondLOD();
+			}
+		}
+		else
+		{
+			blendSecondLOD();
+		}
 	}
 
 	return c;
@@ -1093,6 +1132,13 @@ Vector4f SamplerCore::sampleFloatAniso(Pointer<Byte> &texture, Float4 &u, Float4
 	{
 		Int N = RoundInt(anisotropy);
 
+		if(secondLOD)
+		{
+			// The next mipmap level has half the texel density along the major axis,
+			// so half as many taps cover the same footprint.
+			N = (N + 1) >> 1;
+		}
+
 		Vector4f cSum;
 
 		cSum.x = Float4(0.0f);
@@ -1196,13 +1242,13 @@ Vector4f SamplerCore::sampleFloat2D(Pointer<Byte> &texture, Float4 &u, Float4 &v
 
 	if(state.textureFilter == FILTER_POINT || (function == Fetch))
 	{
-		c = sampleTexel(x0, y0, z, dRef, sample, mipmap, buffer);
+		c = sampleTexel(x0, y0, z, dRef, sample, mipmap, buffer, true);
 	}
 	else
 	{
 		y1 *= pitchP;
 
-		Vector4f c00 = sampleTexel(x0, y0, z, dRef, sample, mipmap, buffer);
+		Vector4f c00 = sampleTexel(x0, y0, z, dRef, sample, mipmap, buffer, true);
 		Vector4f c10 = sampleTexel(x1, y0, z, dRef, sample, mipmap, buffer);
 		Vector4f c01 = sampleTexel(x0, y1, z, dRef, sample, mipmap, buffer);
 		Vector4f c11 = sampleTexel(x1, y1, z, dRef, sample, mipmap, buffer);
@@ -2077,17 +2123,40 @@ void SamplerCore::sampleChromaTexel(Vector4f &output, Short4 &uuuu, Short4 &vvvv
 	output.z = Float4(U);
 }
 
-Vector4s SamplerCore::sampleTexel(Short4 &uuuu, Short4 &vvvv, Short4 &wwww, const Short4 &layerIndex, const Int4 &sample, Pointer<Byte> &mipmap, Pointer<Byte> buffer)
+void SamplerCore::prefetchNextQuad(UInt index[4], const Pointer<Byte> &buffer)
+{
+	if(function == Fetch || state.textureFormat.isCompressed())
+	{
+		return;
+	}
+
+	// Quads are shaded left to right along a scanline, so the next quad's footprint is
+	// approximately this one's, displaced by twice the distance between horizontal neighbors.
+	// Prefetching is only a hint, so predicted addresses outside the image are harmless.
+	int bytes = state.textureFormat.bytes();
+	Int next0 = Int(index[0]) + 2 * (Int(index[1]) - Int(index[0]));
+	Int next2 = Int(index[2]) + 2 * (Int(index[3]) - Int(index[2]));
+
+	Prefetch(buffer + next0 * bytes);
+	Prefetch(buffer + next2 * bytes);
+}
+
+Vector4s SamplerCore::sampleTexel(Short4 &uuuu, Short4 &vvvv, Short4 &wwww, const Short4 &layerIndex, const Int4 &sample, Pointer<Byte> &mipmap, Pointer<Byte> buffer, bool prefetch)
 {
 	ASSERT(!isYcbcrFormat());
 
 	UInt index[4];
 	computeIndices(index, uuuu, vvvv, wwww, layerIndex, sample, mipmap);
 
+	if(prefetch)
+	{
+		prefetchNextQuad(index, buffer);
+	}
+
 	return sampleTexel(index, buffer);
 }
 
-Vector4f SamplerCore::sampleTexel(Int4 &uuuu, Int4 &vvvv, Int4 &wwww, const Float4 &dRef, const Int4 &sample, Pointer<Byte> &mipmap, Pointer<Byte> buffer)
+Vector4f SamplerCore::sampleTexel(Int4 &uuuu, Int4 &vvvv, Int4 &wwww, const Float4 &dRef, const Int4 &sample, Pointer<Byte> &mipmap, Pointer<Byte> buffer, bool prefetch)
 {
 	Int4 valid;
 
@@ -2103,6 +2172,11 @@ Vector4f SamplerCore::sampleTexel(Int4 &uuuu, Int4 &vvvv, Int4 &wwww, const Floa
 	UInt index[4];
 	computeIndices(index, uuuu, vvvv, wwww, sample, valid, mipmap);
 
+	if(prefetch)
+	{
+		prefetchNextQuad(index, buffer);
+	}
+
 	Vector4f c;
 
 	if(hasFloatTexture() || has32bitIntegerTextureComponents())
@@ -304,6 +304,17 @@ void SetupRoutine::generate()
 		w012.z = w2;
 		w012.w = 1;
 
+		// Primitives with constant w don't need perspective correction. Scale the perspective-correct
+		// gradients by w, making them equivalent to linear ones, so the pixel routine can skip the division.
+		Bool affine = (w0 == w1) && (w1 == w2);
+		*Pointer<Int>(primitive + OFFSET(Primitive, affine)) = IfThenElse(affine, Int(1), Int(0));
+
+		Float4 perspectiveW012 = Float4(1.0f);
+		If(affine)
+		{
+			perspectiveW012 = w012;
+		}
+
 		Float rhw0 = *Pointer<Float>(v0 + OFFSET(Vertex, projected.w));
 
 		Int X0 = *Pointer<Int>(v0 + OFFSET(Vertex, projected.x));
@@ -480,7 +491,7 @@ void SetupRoutine::generate()
 		{
 			if(state.gradient[interfaceInterpolant].Type != SpirvShader::ATTRIBTYPE_UNUSED)
 			{
-				setupGradient(primitive, tri, w012, M, v0, v1, v2,
+				setupGradient(primitive, tri, w012, perspectiveW012, M, v0, v1, v2,
 				              OFFSET(Vertex, v[interfaceInterpolant]),
 				              OFFSET(Primitive, V[packedInterpolant]),
 				              state.gradient[interfaceInterpolant].Flat,
@@ -491,7 +502,7 @@ void SetupRoutine::generate()
 
 		for(unsigned int i = 0; i < state.numClipDistances; i++)
 		{
-			setupGradient(primitive, tri, w012, M, v0, v1, v2,
+			setupGradient(primitive, tri, w012, perspectiveW012, M, v0, v1, v2,
 			              OFFSET(Vertex, clipDistance[i]),
 			              OFFSET(Primitive, clipDistance[i]),
 			              false, true);
@@ -499,7 +510,7 @@ void SetupRoutine::generate()
 
 		for(unsigned int i = 0; i < state.numCullDistances; i++)
 		{
-			setupGradient(primitive, tri, w012, M, v0, v1, v2,
+			setupGradient(primitive, tri, w012, perspectiveW012, M, v0, v1, v2,
 			              OFFSET(Vertex, cullDistance[i]),
 			              OFFSET(Primitive, cullDistance[i]),
 			              false, true);
@@ -511,7 +522,7 @@ void SetupRoutine::generate()
 	routine = function("SetupRoutine");
 }
 
-void SetupRoutine::setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &triangle, Float4 &w012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, bool flat, bool perspective)
+void SetupRoutine::setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &triangle, Float4 &w012, Float4 &perspectiveW012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, bool flat, bool perspective)
 {
 	if(!flat)
 	{
@@ -525,6 +536,10 @@ void SetupRoutine::setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &triang
 		{
 			i *= w012;
 		}
+		else
+		{
+			i *= perspectiveW012;
+		}
 
 		Float4 A = i.xxxx * m[0];
 		Float4 B = i.yyyy * m[1];
@@ -598,12 +613,31 @@ void SetupRoutine::edge(Pointer<Byte> &primitive, Pointer<Byte> &data, const Int
 			Int D = FDY12;  // Error-overflow
 			Int y = y1;
 
+			// Edges of unclipped primitives within the guard band can start far above the
+			// scissor rectangle. Advance by n rows at once. The error-term overflow count
+			// doesn't fit in 32-bit arithmetic, so estimate it in floating-point and correct
+			// the remainder, which is exact modulo 2^32 and small enough to not wrap.
+			If(y < yMin)
+			{
+				Int n = yMin - y;
+				Int k = RoundInt((Float(n) * Float(R) + Float(d)) / Float(D));
+				d = d + n * R - k * D;
+
+				Int over = -d >> 31;
+				d -= D & over;
+				k -= over;
+
+				Int under = (-D - d) >> 31;
+				d += D & ~under;
+				k -= ~under & 1;
+
+				x += n * Q + k;
+				y = yMin;
+			}
+
 			Do
 			{
-				If(y >= yMin)
-				{
-					*Pointer<Short>(edge + y * sizeof(Primitive::Span)) = Short(Clamp(x, xMin, xMax));
-				}
+				*Pointer<Short>(edge + y * sizeof(Primitive::Span)) = Short(Clamp(x, xMin, xMax));
 
 				x += Q;
 				d += R;
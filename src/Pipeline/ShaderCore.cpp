@@ -14,6 +14,7 @@
 
 #include "ShaderCore.hpp"
 
+#include "Constants.hpp"
 #include "Device/Renderer.hpp"
 #include "Reactor/Assert.hpp"
 #include "System/Debug.hpp"
@@ -673,7 +674,13 @@ UInt4 floatToHalfBits(RValue<UInt4> floatBits, bool storeInUpperBits)
 SIMD::Float linearToSRGB(const SIMD::Float &c)
 {
 	SIMD::Float lc = c * 12.92f;
-	SIMD::Float ec = MulAdd(1.055f, Pow<Mediump>(c, (1.0f / 2.4f)), -0.055f);  // TODO(b/149574741): Use a custom approximation.
+
+	// Rational approximation of 1.055 * c^(1/2.4) - 0.055 in terms of sqrt(c), for c in [0.0031308, 1].
+	// The absolute error is below 0.001 of an 8-bit unit, and sRGB formats are 8-bit.
+	SIMD::Float s = Sqrt(c);
+	SIMD::Float p = MulAdd(MulAdd(MulAdd(s, 17.9387417f, 17.8463020f), s, 1.17479038f), s, -0.0489373766f);
+	SIMD::Float q = MulAdd(MulAdd(MulAdd(s, 0.884471238f, 20.5584145f), s, 14.4681358f), s, 1.0f);
+	SIMD::Float ec = p / q;
 
 	SIMD::Int linear = CmpLT(c, 0.0031308f);
 	return As<SIMD::Float>((linear & As<SIMD::Int>(lc)) | (~linear & As<SIMD::Int>(ec)));  // TODO: IfThenElse()
@@ -682,12 +689,30 @@ SIMD::Float linearToSRGB(const SIMD::Float &c)
 SIMD::Float sRGBtoLinear(const SIMD::Float &c)
 {
 	SIMD::Float lc = c * (1.0f / 12.92f);
-	SIMD::Float ec = Pow<Mediump>(MulAdd(c, 1.0f / 1.055f, 0.055f / 1.055f), 2.4f);  // TODO(b/149574741): Use a custom approximation.
+
+	// Rational approximation of ((c + 0.055) / 1.055)^2.4, for c in [0.04045, 1].
+	// The relative error is below 3e-6. 8-bit sources should use sRGB8toLinear() instead.
+	SIMD::Float p = MulAdd(MulAdd(MulAdd(MulAdd(c, 2.58019376f, 2.85195398f), c, 0.604867399f), c, 0.0393958874f), c, 0.000835549494f);
+	SIMD::Float q = MulAdd(MulAdd(MulAdd(c, -0.0920154378f, 1.40697956f), c, 3.76227045f), c, 1.0f);
+	SIMD::Float ec = p / q;
 
 	SIMD::Int linear = CmpLT(c, 0.04045f);
 	return As<SIMD::Float>((linear & As<SIMD::Int>(lc)) | (~linear & As<SIMD::Int>(ec)));  // TODO: IfThenElse()
 }
 
+SIMD::Float sRGB8toLinear(const SIMD::Int &c, const Pointer<Byte> &constants)
+{
+	Pointer<Byte> LUT = constants + OFFSET(Constants, sRGBtoLinearFF_F);
+
+	SIMD::Float linear;
+	for(int i = 0; i < SIMD::Width; i++)
+	{
+		linear = Insert(linear, *Pointer<Float>(LUT + 4 * Extract(c, i)), i);
+	}
+
+	return linear;
+}
+
 RValue<Float4> reciprocal(RValue<Float4> x, bool pp, bool exactAtPow2)
 {
 	return Rcp(x, pp, exactAtPow2);
@@ -914,7 +939,13 @@ UInt r11g11b10Pack(const Float4 &value)
 Float4 linearToSRGB(const Float4 &c)
 {
 	Float4 lc = c * 12.92f;
-	Float4 ec = MulAdd(1.055f, Pow<Mediump>(c, (1.0f / 2.4f)), -0.055f);  // TODO(b/149574741): Use a custom approximation.
+
+	// Rational approximation of 1.055 * c^(1/2.4) - 0.055 in terms of sqrt(c), for c in [0.0031308, 1].
+	// The absolute error is below 0.001 of an 8-bit unit, and sRGB formats are 8-bit.
+	Float4 s = Sqrt(c);
+	Float4 p = MulAdd(MulAdd(MulAdd(s, 17.9387417f, 17.8463020f), s, 1.17479038f), s, -0.0489373766f);
+	Float4 q = MulAdd(MulAdd(MulAdd(s, 0.884471238f, 20.5584145f), s, 14.4681358f), s, 1.0f);
+	Float4 ec = p / q;
 
 	Int4 linear = CmpLT(c, 0.0031308f);
 	return As<Float4>((linear & As<Int4>(lc)) | (~linear & As<Int4>(ec)));  // TODO: IfThenElse()
@@ -923,12 +954,30 @@ Float4 linearToSRGB(const Float4 &c)
 Float4 sRGBtoLinear(const Float4 &c)
 {
 	Float4 lc = c * (1.0f / 12.92f);
-	Float4 ec = Pow<Mediump>(MulAdd(c, 1.0f / 1.055f, 0.055f / 1.055f), 2.4f);  // TODO(b/149574741): Use a custom approximation.
+
+	// Rational approximation of ((c + 0.055) / 1.055)^2.4, for c in [0.04045, 1].
+	// The relative error is below 3e-6. 8-bit sources should use sRGB8toLinear() instead.
+	Float4 p = MulAdd(MulAdd(MulAdd(MulAdd(c, 2.58019376f, 2.85195398f), c, 0.604867399f), c, 0.0393958874f), c, 0.000835549494f);
+	Float4 q = MulAdd(MulAdd(MulAdd(c, -0.0920154378f, 1.40697956f), c, 3.76227045f), c, 1.0f);
+	Float4 ec = p / q;
 
 	Int4 linear = CmpLT(c, 0.04045f);
 	return As<Float4>((linear & As<Int4>(lc)) | (~linear & As<Int4>(ec)));  // TODO: IfThenElse()
 }
 
+Float4 sRGB8toLinear(const Int4 &c, const Pointer<Byte> &constants)
+{
+	Pointer<Byte> LUT = constants + OFFSET(Constants, sRGBtoLinearFF_F);
+
+	Float4 linear;
+	linear.x = *Pointer<Float>(LUT + 4 * Extract(c, 0));
+	linear.y = *Pointer<Float>(LUT + 4 * Extract(c, 1));
+	linear.z = *Pointer<Float>(LUT + 4 * Extract(c, 2));
+	linear.w = *Pointer<Float>(LUT + 4 * Extract(c, 3));
+
+	return linear;
+}
+
 rr::RValue<SIMD::Float> Sign(const rr::RValue<SIMD::Float> &val)
 {
 	return rr::As<SIMD::Float>((rr::As<SIMD::UInt>(val) & SIMD::UInt(0x80000000)) | SIMD::UInt(0x3f800000));
@@ -150,6 +150,7 @@ SIMD::UInt halfToFloatBits(SIMD::UInt halfBits);
 SIMD::UInt floatToHalfBits(SIMD::UInt floatBits, bool storeInUpperBits);
 SIMD::Float linearToSRGB(const SIMD::Float &c);
 SIMD::Float sRGBtoLinear(const SIMD::Float &c);
+SIMD::Float sRGB8toLinear(const SIMD::Int &c, const Pointer<Byte> &constants);  // c in [0, 255]
 
 RValue<Float4> reciprocal(RValue<Float4> x, bool pp = false, bool exactAtPow2 = false);
 RValue<SIMD::Float> reciprocal(RValue<SIMD::Float> x, bool pp = false, bool exactAtPow2 = false);
@@ -186,6 +187,7 @@ Float4 r11g11b10Unpack(UInt r11g11b10bits);
 UInt r11g11b10Pack(const Float4 &value);
 Float4 linearToSRGB(const Float4 &c);
 Float4 sRGBtoLinear(const Float4 &c);
+Float4 sRGB8toLinear(const Int4 &c, const Pointer<Byte> &constants);  // c in [0, 255]
 
 template<typename T>
 inline rr::RValue<T> AndAll(const rr::RValue<T> &mask);
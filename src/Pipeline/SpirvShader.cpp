@@ -667,44 +667,17 @@ Spirv::Spirv(
 		case spv::OpIsNan:
 		case spv::OpAny:
 		case spv::OpAll:
-		case spv::OpDPdx:
-		case spv::OpDPdxCoarse:
-		case spv::OpDPdy:
-		case spv::OpDPdyCoarse:
-		case spv::OpFwidth:
-		case spv::OpFwidthCoarse:
-		case spv::OpDPdxFine:
-		case spv::OpDPdyFine:
-		case spv::OpFwidthFine:
 		case spv::OpAtomicLoad:
-		case spv::OpAtomicIAdd:
-		case spv::OpAtomicISub:
-		case spv::OpAtomicSMin:
-		case spv::OpAtomicSMax:
-		case spv::OpAtomicUMin:
-		case spv::OpAtomicUMax:
-		case spv::OpAtomicAnd:
-		case spv::OpAtomicOr:
-		case spv::OpAtomicXor:
-		case spv::OpAtomicIIncrement:
-		case spv::OpAtomicIDecrement:
-		case spv::OpAtomicExchange:
-		case spv::OpAtomicCompareExchange:
 		case spv::OpPhi:
-		case spv::OpImageSampleImplicitLod:
 		case spv::OpImageSampleExplicitLod:
-		case spv::OpImageSampleDrefImplicitLod:
 		case spv::OpImageSampleDrefExplicitLod:
-		case spv::OpImageSampleProjImplicitLod:
 		case spv::OpImageSampleProjExplicitLod:
-		case spv::OpImageSampleProjDrefImplicitLod:
 		case spv::OpImageSampleProjDrefExplicitLod:
 		case spv::OpImageGather:
 		case spv::OpImageDrefGather:
 		case spv::OpImageFetch:
 		case spv::OpImageQuerySizeLod:
 		case spv::OpImageQuerySize:
-		case spv::OpImageQueryLod:
 		case spv::OpImageQueryLevels:
 		case spv::OpImageQuerySamples:
 		case spv::OpImageRead:
@@ -715,8 +688,6 @@ Spirv::Spirv(
 		case spv::OpGroupNonUniformAllEqual:
 		case spv::OpGroupNonUniformBroadcast:
 		case spv::OpGroupNonUniformBroadcastFirst:
-		case spv::OpGroupNonUniformQuadBroadcast:
-		case spv::OpGroupNonUniformQuadSwap:
 		case spv::OpGroupNonUniformBallot:
 		case spv::OpGroupNonUniformInverseBallot:
 		case spv::OpGroupNonUniformBallotBitExtract:
@@ -749,6 +720,47 @@ Spirv::Spirv(
 			DefineResult(insn);
 			break;
 
+		case spv::OpDPdx:
+		case spv::OpDPdxCoarse:
+		case spv::OpDPdy:
+		case spv::OpDPdyCoarse:
+		case spv::OpFwidth:
+		case spv::OpFwidthCoarse:
+		case spv::OpDPdxFine:
+		case spv::OpDPdyFine:
+		case spv::OpFwidthFine:
+		case spv::OpImageSampleImplicitLod:
+		case spv::OpImageSampleDrefImplicitLod:
+		case spv::OpImageSampleProjImplicitLod:
+		case spv::OpImageSampleProjDrefImplicitLod:
+		case spv::OpImageQueryLod:
+		case spv::OpGroupNonUniformQuadBroadcast:
+		case spv::OpGroupNonUniformQuadSwap:
+			// Instructions which observe neighboring invocations in the quad, and thus need helper invocations
+			analysis.ContainsDerivatives = true;
+			DefineResult(insn);
+			break;
+
+		case spv::OpAtomicIAdd:
+		case spv::OpAtomicISub:
+		case spv::OpAtomicSMin:
+		case spv::OpAtomicSMax:
+		case spv::OpAtomicUMin:
+		case spv::OpAtomicUMax:
+		case spv::OpAtomicAnd:
+		case spv::OpAtomicOr:
+		case spv::OpAtomicXor:
+		case spv::OpAtomicIIncrement:
+		case spv::OpAtomicIDecrement:
+		case spv::OpAtomicExchange:
+		case spv::OpAtomicCompareExchange:
+			if(StoresInHelperInvocationsHaveNoEffect(getObjectType(insn.word(3)).storageClass))
+			{
+				analysis.ContainsSideEffects = true;
+			}
+			DefineResult(insn);
+			break;
+
 		case spv::OpExtInst:
 			switch(getExtension(insn.word(3)).name)
 			{
@@ -769,12 +781,20 @@ Spirv::Spirv(
 		case spv::OpStore:
 		case spv::OpAtomicStore:
 		case spv::OpCopyMemory:
+			// Stores to externally visible memory must not be optimized away
+			if(StoresInHelperInvocationsHaveNoEffect(getObjectType(insn.word(1)).storageClass))
+			{
+				analysis.ContainsSideEffects = true;
+			}
+			break;
+
 		case spv::OpMemoryBarrier:
 			// Don't need to do anything during analysis pass
 			break;
 
 		case spv::OpImageWrite:
 			analysis.ContainsImageWrite = true;
+			analysis.ContainsSideEffects = true;
 			break;
 
 		case spv::OpControlBarrier:
@@ -2599,6 +2619,166 @@ void SpirvEmitter::EmitAll(InsnIterator insn)
 	dst.move(0, result);
 }
 
+// Performs an atomic operation on a single address, returning the original value.
+static RValue<UInt> EmitAtomic(spv::Op opcode, Pointer<Byte> address, RValue<UInt> value, std::memory_order memoryOrder)
+{
+	switch(opcode)
+	{
+	case spv::OpAtomicIAdd:
+	case spv::OpAtomicIIncrement:
+		return AddAtomic(Pointer<UInt>(address), value, memoryOrder);
+	case spv::OpAtomicISub:
+	case spv::OpAtomicIDecrement:
+		return SubAtomic(Pointer<UInt>(address), value, memoryOrder);
+	case spv::OpAtomicAnd:
+		return AndAtomic(Pointer<UInt>(address), value, memoryOrder);
+	case spv::OpAtomicOr:
+		return OrAtomic(Pointer<UInt>(address), value, memoryOrder);
+	case spv::OpAtomicXor:
+		return XorAtomic(Pointer<UInt>(address), value, memoryOrder);
+	case spv::OpAtomicSMin:
+		return As<UInt>(MinAtomic(Pointer<Int>(address), As<Int>(value), memoryOrder));
+	case spv::OpAtomicSMax:
+		return As<UInt>(MaxAtomic(Pointer<Int>(address), As<Int>(value), memoryOrder));
+	case spv::OpAtomicUMin:
+		return MinAtomic(Pointer<UInt>(address), value, memoryOrder);
+	case spv::OpAtomicUMax:
+		return MaxAtomic(Pointer<UInt>(address), value, memoryOrder);
+	case spv::OpAtomicExchange:
+		return ExchangeAtomic(Pointer<UInt>(address), value, memoryOrder);
+	default:
+		UNREACHABLE("%s", Spirv::OpcodeName(opcode));
+		return UInt(0);
+	}
+}
+
+// Returns false for atomic operations whose operands can't be combined into a single
+// operand, or provides the operand which leaves the memory unchanged.
+static bool GetAtomicIdentity(spv::Op opcode, uint32_t &identity)
+{
+	switch(opcode)
+	{
+	case spv::OpAtomicIAdd:
+	case spv::OpAtomicIIncrement:
+	case spv::OpAtomicISub:
+	case spv::OpAtomicIDecrement:
+	case spv::OpAtomicOr:
+	case spv::OpAtomicXor:
+	case spv::OpAtomicUMax:
+		identity = 0;
+		return true;
+	case spv::OpAtomicAnd:
+	case spv::OpAtomicUMin:
+		identity = 0xFFFFFFFF;
+		return true;
+	case spv::OpAtomicSMin:
+		identity = 0x7FFFFFFF;
+		return true;
+	case spv::OpAtomicSMax:
+		identity = 0x80000000;
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Combines the operands of two atomic operations on the same address into one.
+// Subtractions accumulate the amount to subtract.
+static RValue<UInt> CombineAtomicOperands(spv::Op opcode, RValue<UInt> x, RValue<UInt> y)
+{
+	switch(opcode)
+	{
+	case spv::OpAtomicIAdd:
+	case spv::OpAtomicIIncrement:
+	case spv::OpAtomicISub:
+	case spv::OpAtomicIDecrement:
+		return x + y;
+	case spv::OpAtomicAnd:
+		return x & y;
+	case spv::OpAtomicOr:
+		return x | y;
+	case spv::OpAtomicXor:
+		return x ^ y;
+	case spv::OpAtomicSMin:
+		return As<UInt>(Min(As<Int>(x), As<Int>(y)));
+	case spv::OpAtomicSMax:
+		return As<UInt>(Max(As<Int>(x), As<Int>(y)));
+	case spv::OpAtomicUMin:
+		return Min(x, y);
+	case spv::OpAtomicUMax:
+		return Max(x, y);
+	default:
+		UNREACHABLE("%s", Spirv::OpcodeName(opcode));
+		return x;
+	}
+}
+
+// Applies operands to memory values the way the atomic operation does. For the
+// combined operands of preceding lanes, this yields the value each lane would have
+// observed with separate operations.
+static RValue<SIMD::UInt> ApplyAtomicOperands(spv::Op opcode, RValue<SIMD::UInt> original, RValue<SIMD::UInt> preceding)
+{
+	switch(opcode)
+	{
+	case spv::OpAtomicIAdd:
+	case spv::OpAtomicIIncrement:
+		return original + preceding;
+	case spv::OpAtomicISub:
+	case spv::OpAtomicIDecrement:
+		return original - preceding;
+	case spv::OpAtomicAnd:
+		return original & preceding;
+	case spv::OpAtomicOr:
+		return original | preceding;
+	case spv::OpAtomicXor:
+		return original ^ preceding;
+	case spv::OpAtomicSMin:
+		return As<SIMD::UInt>(Min(As<SIMD::Int>(original), As<SIMD::Int>(preceding)));
+	case spv::OpAtomicSMax:
+		return As<SIMD::UInt>(Max(As<SIMD::Int>(original), As<SIMD::Int>(preceding)));
+	case spv::OpAtomicUMin:
+		return Min(original, preceding);
+	case spv::OpAtomicUMax:
+		return Max(original, preceding);
+	default:
+		UNREACHABLE("%s", Spirv::OpcodeName(opcode));
+		return original;
+	}
+}
+
+// Performs the read-modify-write of an atomic operation with plain loads and stores,
+// returning the original value.
+static RValue<UInt> EmitNonAtomic(spv::Op opcode, Pointer<Byte> address, RValue<UInt> value)
+{
+	UInt original = *Pointer<UInt>(address);
+
+	switch(opcode)
+	{
+	case spv::OpAtomicISub:
+	case spv::OpAtomicIDecrement:
+		*Pointer<UInt>(address) = original - value;
+		break;
+	case spv::OpAtomicExchange:
+		*Pointer<UInt>(address) = value;
+		break;
+	default:
+		*Pointer<UInt>(address) = CombineAtomicOperands(opcode, original, value);
+		break;
+	}
+
+	return original;
+}
+
+// Performs the compare-exchange of an atomic operation with plain loads and stores,
+// returning the original value.
+static RValue<UInt> EmitNonAtomicCompareExchange(Pointer<Byte> address, RValue<UInt> value, RValue<UInt> comparator)
+{
+	UInt original = *Pointer<UInt>(address);
+	*Pointer<UInt>(address) = IfThenElse(original == comparator, value, original);
+
+	return original;
+}
+
 void SpirvEmitter::EmitAtomicOp(InsnIterator insn)
 {
 	auto &resultType = shader.getType(Type::ID(insn.word(1)));
@@ -2611,6 +2791,7 @@ void SpirvEmitter::EmitAtomicOp(InsnIterator insn)
 	auto value = (insn.wordCount() == 7) ? Operand(shader, *this, insn.word(6)).UInt(0) : RValue<SIMD::UInt>(1);
 	auto &dst = createIntermediate(resultId, resultType.componentCount);
 	auto ptr = getPointer(pointerId);
+	spv::Op opcode = insn.opcode();
 
 	SIMD::Int mask = activeLaneMask() & storesAndAtomicsMask();
 
@@ -2619,52 +2800,111 @@ void SpirvEmitter::EmitAtomicOp(InsnIterator insn)
 		mask &= ptr.isInBounds(sizeof(int32_t), OutOfBoundsBehavior::Nullify);
 	}
 
+	// All invocations of a workgroup run as coroutines on the same thread, which only
+	// switch at control barriers, so workgroup memory needs no atomic instructions.
+	bool workgroup = shader.getType(shader.getObject(pointerId)).storageClass == spv::StorageClassWorkgroup;
+
+	auto emitSingle = [&](Pointer<Byte> address, RValue<UInt> v) -> RValue<UInt> {
+		return workgroup ? EmitNonAtomic(opcode, address, v) : EmitAtomic(opcode, address, v, memoryOrder);
+	};
+
 	SIMD::UInt result(0);
-	for(int j = 0; j < SIMD::Width; j++)
-	{
-		If(Extract(mask, j) != 0)
+
+	auto emitPerLane = [&]() {
+		for(int j = 0; j < SIMD::Width; j++)
 		{
-			auto laneValue = Extract(value, j);
-			UInt v;
-			switch(insn.opcode())
+			If(Extract(mask, j) != 0)
 			{
-			case spv::OpAtomicIAdd:
-			case spv::OpAtomicIIncrement:
-				v = AddAtomic(Pointer<UInt>(ptr.getPointerForLane(j)), laneValue, memoryOrder);
-				break;
-			case spv::OpAtomicISub:
-			case spv::OpAtomicIDecrement:
-				v = SubAtomic(Pointer<UInt>(ptr.getPointerForLane(j)), laneValue, memoryOrder);
-				break;
-			case spv::OpAtomicAnd:
-				v = AndAtomic(Pointer<UInt>(ptr.getPointerForLane(j)), laneValue, memoryOrder);
-				break;
-			case spv::OpAtomicOr:
-				v = OrAtomic(Pointer<UInt>(ptr.getPointerForLane(j)), laneValue, memoryOrder);
-				break;
-			case spv::OpAtomicXor:
-				v = XorAtomic(Pointer<UInt>(ptr.getPointerForLane(j)), laneValue, memoryOrder);
-				break;
-			case spv::OpAtomicSMin:
-				v = As<UInt>(MinAtomic(Pointer<Int>(ptr.getPointerForLane(j)), As<Int>(laneValue), memoryOrder));
-				break;
-			case spv::OpAtomicSMax:
-				v = As<UInt>(MaxAtomic(Pointer<Int>(ptr.getPointerForLane(j)), As<Int>(laneValue), memoryOrder));
-				break;
-			case spv::OpAtomicUMin:
-				v = MinAtomic(Pointer<UInt>(ptr.getPointerForLane(j)), laneValue, memoryOrder);
-				break;
-			case spv::OpAtomicUMax:
-				v = MaxAtomic(Pointer<UInt>(ptr.getPointerForLane(j)), laneValue, memoryOrder);
-				break;
-			case spv::OpAtomicExchange:
-				v = ExchangeAtomic(Pointer<UInt>(ptr.getPointerForLane(j)), laneValue, memoryOrder);
-				break;
-			default:
-				UNREACHABLE("%s", shader.OpcodeName(insn.opcode()));
-				break;
+				UInt v = emitSingle(ptr.getPointerForLane(j), Extract(value, j));
+				result = Insert(result, v, j);
 			}
-			result = Insert(result, v, j);
+		}
+	};
+
+	// Lanes accessing distinct workgroup memory addresses are updated all at once.
+	auto emitVector = [&]() {
+		auto robustness = shader.getOutOfBoundsBehavior(pointerId, routine->pipelineLayout);
+		SIMD::UInt original = As<SIMD::UInt>(ptr.Load<SIMD::Int>(robustness, mask));
+		SIMD::UInt updated = (opcode == spv::OpAtomicExchange) ? SIMD::UInt(value) : SIMD::UInt(ApplyAtomicOperands(opcode, original, value));
+		ptr.Store(As<SIMD::Int>(updated), robustness, mask);
+		result = original;
+	};
+
+	// Lanes sharing an address, as for counters and histogram bins, have their operands
+	// combined into a single operation. Each remaining active lane in turn leads the group
+	// of remaining lanes which access the same address as it does.
+	uint32_t identity = 0;
+	bool combinable = GetAtomicIdentity(opcode, identity);
+
+	auto emitGrouped = [&]() {
+		SIMD::Int offsets = ptr.offsets();
+		SIMD::Int remaining = mask;
+
+		for(int j = 0; j < SIMD::Width; j++)
+		{
+			If(Extract(remaining, j) != 0)
+			{
+				SIMD::Int group = remaining & CmpEQ(offsets, SIMD::Int(Extract(offsets, j)));
+				remaining &= ~group;
+
+				SIMD::UInt operands = (value & As<SIMD::UInt>(group)) | (SIMD::UInt(identity) & ~As<SIMD::UInt>(group));
+
+				// Lanes observe the effect of the preceding lanes, as if performed in lane order.
+				SIMD::UInt preceding(identity);
+				UInt combined = identity;
+				for(int k = 0; k < SIMD::Width; k++)
+				{
+					preceding = Insert(preceding, combined, k);
+					combined = CombineAtomicOperands(opcode, combined, Extract(operands, k));
+				}
+
+				UInt original = emitSingle(ptr.getPointerForLane(j), combined);
+				SIMD::UInt groupResult = ApplyAtomicOperands(opcode, SIMD::UInt(original), preceding);
+				result = (groupResult & As<SIMD::UInt>(group)) | (result & ~As<SIMD::UInt>(group));
+			}
+		}
+	};
+
+	auto emitScalar = [&]() {
+		if(combinable)
+		{
+			emitGrouped();
+		}
+		else
+		{
+			emitPerLane();
+		}
+	};
+
+	if(!ptr.isBasePlusOffset)
+	{
+		emitPerLane();
+	}
+	else if(!workgroup)
+	{
+		emitScalar();
+	}
+	else if(ptr.hasStaticSequentialOffsets(sizeof(uint32_t)))
+	{
+		emitVector();
+	}
+	else
+	{
+		SIMD::Int offsets = ptr.offsets();
+		SIMD::Int collisions(0);
+		for(int j = 0; j < SIMD::Width; j++)
+		{
+			SIMD::Int otherLanes([j](int i) { return (i == j) ? 0 : -1; });
+			collisions |= CmpEQ(offsets, SIMD::Int(Extract(offsets, j))) & SIMD::Int(Extract(mask, j)) & otherLanes;
+		}
+
+		If(AnyTrue(collisions & mask))
+		{
+			emitScalar();
+		}
+		Else
+		{
+			emitVector();
 		}
 	}
 
@@ -2685,7 +2925,11 @@ void SpirvEmitter::EmitAtomicCompareExchange(InsnIterator insn)
 	auto value = Operand(shader, *this, insn.word(7));
 	auto comparator = Operand(shader, *this, insn.word(8));
 	auto &dst = createIntermediate(resultId, resultType.componentCount);
-	auto ptr = getPointer(insn.word(3));
+	Object::ID pointerId = insn.word(3);
+	auto ptr = getPointer(pointerId);
+
+	// Like other atomics, compare-exchange on workgroup memory needs no atomic instructions.
+	bool workgroup = shader.getType(shader.getObject(pointerId)).storageClass == spv::StorageClassWorkgroup;
 
 	SIMD::UInt x(0);
 	auto mask = activeLaneMask() & storesAndAtomicsMask();
@@ -2695,7 +2939,8 @@ void SpirvEmitter::EmitAtomicCompareExchange(InsnIterator insn)
 		{
 			auto laneValue = Extract(value.UInt(0), j);
 			auto laneComparator = Extract(comparator.UInt(0), j);
-			UInt v = CompareExchangeAtomic(Pointer<UInt>(ptr.getPointerForLane(j)), laneValue, laneComparator, memoryOrderEqual, memoryOrderUnequal);
+			UInt v = workgroup ? EmitNonAtomicCompareExchange(ptr.getPointerForLane(j), laneValue, laneComparator)
+			                   : CompareExchangeAtomic(Pointer<UInt>(ptr.getPointerForLane(j)), laneValue, laneComparator, memoryOrderEqual, memoryOrderUnequal);
 			x = Insert(x, v, j);
 		}
 	}
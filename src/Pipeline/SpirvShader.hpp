@@ -565,10 +565,13 @@ public:
 		bool NeedsCentroid : 1;
 		bool ContainsSampleQualifier : 1;
 		bool ContainsImageWrite : 1;
+		bool ContainsSideEffects : 1;  // Stores, atomics, or image writes to externally visible memory
+		bool ContainsDerivatives : 1;  // Derivatives, implicit LOD sampling, or quad operations
 	};
 
 	const Analysis &getAnalysis() const { return analysis; }
 	bool containsImageWrite() const { return analysis.ContainsImageWrite; }
+	bool containsSideEffects() const { return analysis.ContainsSideEffects || analysis.ContainsImageWrite; }
 
 	bool coverageModified() const
 	{
@@ -576,6 +579,16 @@ public:
 		       (outputBuiltins.find(spv::BuiltInSampleMask) != outputBuiltins.end());
 	}
 
+	// Returns true if the shader affects anything other than its color outputs.
+	// Fragment shaders without such effects need not run when no color is written.
+	bool hasNonColorEffects() const
+	{
+		return coverageModified() ||
+		       analysis.ContainsSideEffects ||
+		       (outputBuiltins.find(spv::BuiltInFragDepth) != outputBuiltins.end()) ||
+		       (outputBuiltins.find(spv::BuiltInFragStencilRefEXT) != outputBuiltins.end());
+	}
+
 	struct Capabilities
 	{
 		bool Matrix : 1;
@@ -1475,6 +1488,10 @@ private:
 	static bool IsStorageInterleavedByLane(spv::StorageClass storageClass);
 	static SIMD::Pointer GetElementPointer(SIMD::Pointer structure, uint32_t offset, spv::StorageClass storageClass);
 
+	// Returns true and the word pointed to if the routine is specialized for
+	// the push constant values and the push constant pointer is static.
+	bool GetSpecializedPushConstant(const SIMD::Pointer &ptr, uint32_t &value) const;
+
 	// Returns a SIMD::Pointer to the underlying data for the given pointer
 	// object.
 	// Handles objects of the following kinds:
@@ -1528,6 +1545,11 @@ private:
 	void EmitInstructions(InsnIterator begin, InsnIterator end);
 	void EmitInstruction(InsnIterator insn);
 
+	// Emits the instructions of a block behind a run-time check which jumps
+	// over them when no lanes are active. Returns false if the block is not
+	// suitable for skipping, in which case nothing is emitted.
+	bool EmitInstructionsIfAnyLaneActive(InsnIterator begin, InsnIterator end);
+
 	// Helper for implementing OpStore, which doesn't take an InsnIterator so it
 	// can also store independent operands.
 	void Store(Object::ID pointerId, const Operand &value, bool atomic, std::memory_order memoryOrder) const;
@@ -1638,6 +1660,10 @@ public:
 	Pointer<Byte> constants;
 	Int discardMask = 0;
 
+	// When non-null, the push constant values known at routine generation time,
+	// which statically addressed push constant loads are folded into.
+	const uint8_t *specializedPushConstants = nullptr;
+
 	// Shader invocation state.
 	// Not all of these variables are used for every type of shader, and some
 	// are only used when debugging. See b/146486064 for more information.
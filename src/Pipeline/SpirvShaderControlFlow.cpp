@@ -309,7 +309,10 @@ void SpirvEmitter::EmitNonLoop()
 		SetActiveLaneMask(activeLaneMask);
 	}
 
-	EmitInstructions(block.begin(), block.end());
+	if(blockId == function.entry || !EmitInstructionsIfAnyLaneActive(block.begin(), block.end()))
+	{
+		EmitInstructions(block.begin(), block.end());
+	}
 
 	for(auto out : block.outs)
 	{
@@ -322,6 +325,97 @@ void SpirvEmitter::EmitNonLoop()
 	SPIRV_SHADER_DBG("Block {0} done", blockId);
 }
 
+bool SpirvEmitter::EmitInstructionsIfAnyLaneActive(InsnIterator begin, InsnIterator end)
+{
+	// Blocks with only a few instructions are cheaper to execute than to branch over.
+	constexpr int minSkippableInstructions = 4;
+
+	int instructionCount = 0;
+	InsnIterator terminator = end;
+	for(auto insn = begin; insn != end; insn++)
+	{
+		switch(insn.opcode())
+		{
+		case spv::OpControlBarrier:
+			return false;  // All invocations must reach the barrier to keep the workgroup in sync.
+		case spv::OpLabel:
+		case spv::OpPhi:
+		case spv::OpLine:
+		case spv::OpNoLine:
+		case spv::OpSelectionMerge:
+		case spv::OpLoopMerge:
+			break;
+		default:
+			instructionCount++;
+			break;
+		}
+
+		if(shader.IsTerminator(insn.opcode()))
+		{
+			terminator = insn;
+			break;
+		}
+	}
+
+	if(terminator == end || instructionCount <= minSkippableInstructions)
+	{
+		return false;
+	}
+
+	// Values defined in the block must dominate their uses in subsequent blocks,
+	// so they are spilled to variables which are reloaded after the check.
+	SIMD::Int activeLanes = activeLaneMask();
+	SIMD::Int storesAndAtomics = storesAndAtomicsMask();
+	std::vector<std::pair<Object::ID, uint32_t>> spilledIds;
+	std::vector<std::unique_ptr<SIMD::Int>> spilledValues;
+
+	If(AnyTrue(activeLanes))
+	{
+		EmitInstructions(begin, terminator);
+
+		for(auto insn = begin; insn != terminator; insn++)
+		{
+			if(!insn.hasResultAndType())
+			{
+				continue;
+			}
+
+			auto it = intermediates.find(insn.resultId());
+			if(it != intermediates.end())
+			{
+				spilledIds.emplace_back(it->first, it->second.componentCount);
+				for(uint32_t i = 0; i < it->second.componentCount; i++)
+				{
+					spilledValues.emplace_back(std::make_unique<SIMD::Int>(it->second.Int(i)));
+				}
+			}
+		}
+
+		activeLanes = activeLaneMask();
+		storesAndAtomics = storesAndAtomicsMask();
+	}
+
+	size_t value = 0;
+	for(const auto &spilled : spilledIds)
+	{
+		intermediates.erase(spilled.first);
+		auto &dst = createIntermediate(spilled.first, spilled.second);
+		for(uint32_t i = 0; i < spilled.second; i++)
+		{
+			dst.move(i, RValue<SIMD::Int>(*spilledValues[value++]));
+		}
+	}
+
+	SetActiveLaneMask(activeLanes);
+	SetStoresAndAtomicsMask(storesAndAtomics);
+
+	// The terminator is emitted unconditionally. When the block was skipped, it
+	// produces empty outgoing edge masks, so successors are skipped as well.
+	EmitInstructions(terminator, end);
+
+	return true;
+}
+
 void SpirvEmitter::EmitLoop()
 {
 	auto &function = shader.getFunction(this->function);
@@ -513,7 +607,8 @@ void SpirvEmitter::EmitBranchConditional(InsnIterator insn)
 	auto cond = Operand(shader, *this, condId);
 	ASSERT_MSG(shader.getObjectType(condId).componentCount == 1, "Condition must be a Boolean type scalar");
 
-	// TODO: Optimize for case where all lanes take same path.
+	// When all lanes take the same path, the other successor receives an empty
+	// mask and is skipped at run time by EmitInstructionsIfAnyLaneActive().
 
 	addOutputActiveLaneMaskEdge(trueBlockId, cond.Int(0));
 	addOutputActiveLaneMaskEdge(falseBlockId, ~cond.Int(0));
@@ -533,7 +628,8 @@ void SpirvEmitter::EmitSwitch(InsnIterator insn)
 
 	auto numCases = (block.branchInstruction.wordCount() - 3) / 2;
 
-	// TODO: Optimize for case where all lanes take same path.
+	// Cases which no lanes select receive an empty mask and are skipped at
+	// run time by EmitInstructionsIfAnyLaneActive().
 
 	SIMD::Int defaultLaneMask = activeLaneMask();
 
@@ -74,6 +74,103 @@ static vk::Format SpirvFormatToVulkanFormat(spv::ImageFormat format)
 	}
 }
 
+// Returns true if the lanes address consecutive texels which are all in bounds. This is typical
+// for compute shaders which access an image at their global invocation ID, one row at a time.
+static RValue<Bool> IsRowContiguous(const SIMD::Pointer &texelPtr, int texelSize)
+{
+	if(!texelPtr.isBasePlusOffset)
+	{
+		return Bool(false);
+	}
+
+	SIMD::Int offsets = texelPtr.offsets();
+	SIMD::Int sequential = SIMD::Int(Extract(offsets, 0)) + SIMD::Int([texelSize](int i) { return i * texelSize; });
+	SIMD::Int contiguous = CmpEQ(offsets, sequential) & texelPtr.isInBounds(texelSize, OutOfBoundsBehavior::Nullify);
+
+	return SignMask(contiguous) == ((1 << SIMD::Width) - 1);
+}
+
+// Loads row-contiguous texels with vector loads, and deinterleaves them into the
+// same 32-bit per-lane layout produced by gathering each texel individually.
+static void LoadRowContiguousTexels(const SIMD::Pointer &texelPtr, int texelSize, SIMD::Int packed[4])
+{
+	ASSERT(SIMD::Width == 4);
+	Pointer<Byte> row = texelPtr.getPointerForLane(0);
+
+	switch(texelSize)
+	{
+	case 4:
+		packed[0] = *Pointer<SIMD::Int>(row, sizeof(float));
+		break;
+	case 8:
+		{
+			Float4 texels01 = *Pointer<Float4>(row, sizeof(float));
+			Float4 texels23 = *Pointer<Float4>(row + 16, sizeof(float));
+			packed[0] = As<SIMD::Int>(SIMD::Float(Shuffle(texels01, texels23, 0x0246)));
+			packed[1] = As<SIMD::Int>(SIMD::Float(Shuffle(texels01, texels23, 0x1357)));
+		}
+		break;
+	case 16:
+		{
+			Float4 texel[4];
+			for(int i = 0; i < 4; i++)
+			{
+				texel[i] = *Pointer<Float4>(row + 16 * i, sizeof(float));
+			}
+
+			transpose4x4(texel[0], texel[1], texel[2], texel[3]);
+
+			for(int i = 0; i < 4; i++)
+			{
+				packed[i] = As<SIMD::Int>(SIMD::Float(texel[i]));
+			}
+		}
+		break;
+	default:
+		UNREACHABLE("texelSize: %d", int(texelSize));
+	}
+}
+
+// Stores row-contiguous texels with vector stores. The inverse of LoadRowContiguousTexels().
+static void StoreRowContiguousTexels(const SIMD::Pointer &texelPtr, int texelSize, const SIMD::Int packed[4])
+{
+	ASSERT(SIMD::Width == 4);
+	Pointer<Byte> row = texelPtr.getPointerForLane(0);
+
+	switch(texelSize)
+	{
+	case 4:
+		*Pointer<SIMD::Int>(row, sizeof(float)) = packed[0];
+		break;
+	case 8:
+		{
+			Float4 lo = Extract128(As<SIMD::Float>(packed[0]), 0);
+			Float4 hi = Extract128(As<SIMD::Float>(packed[1]), 0);
+			*Pointer<Float4>(row, sizeof(float)) = Shuffle(lo, hi, 0x0415);
+			*Pointer<Float4>(row + 16, sizeof(float)) = Shuffle(lo, hi, 0x2637);
+		}
+		break;
+	case 16:
+		{
+			Float4 texel[4];
+			for(int i = 0; i < 4; i++)
+			{
+				texel[i] = Extract128(As<SIMD::Float>(packed[i]), 0);
+			}
+
+			transpose4x4(texel[0], texel[1], texel[2], texel[3]);
+
+			for(int i = 0; i < 4; i++)
+			{
+				*Pointer<Float4>(row + 16 * i, sizeof(float)) = texel[i];
+			}
+		}
+		break;
+	default:
+		UNREACHABLE("texelSize: %d", int(texelSize));
+	}
+}
+
 SpirvEmitter::ImageInstruction::ImageInstruction(InsnIterator insn, const Spirv &shader, const SpirvEmitter &state)
     : ImageInstructionSignature(parseVariantAndMethod(insn))
     , position(insn.distanceFrom(shader.begin()))
@@ -877,10 +974,28 @@ void SpirvEmitter::EmitImageRead(const ImageInstruction &instruction)
 	                             : GetNonUniformTexelAddress(instruction, ptr, uvwa, sample, imageFormat, robustness, activeLaneMask(), routine);
 	if(texelSize == 4 || texelSize == 8 || texelSize == 16)
 	{
-		for(auto i = 0; i < texelSize / 4; i++)
+		auto gatherTexels = [&](SIMD::Pointer texelPtr) {
+			for(auto i = 0; i < texelSize / 4; i++)
+			{
+				packed[i] = texelPtr.Load<SIMD::Int>(robustness, activeLaneMask());
+				texelPtr += sizeof(float);
+			}
+		};
+
+		if(texelPtr.isBasePlusOffset && (SIMD::Width == 4))
 		{
-			packed[i] = texelPtr.Load<SIMD::Int>(robustness, activeLaneMask());
-			texelPtr += sizeof(float);
+			If(IsRowContiguous(texelPtr, texelSize))
+			{
+				LoadRowContiguousTexels(texelPtr, texelSize, packed);
+			}
+			Else
+			{
+				gatherTexels(texelPtr);
+			}
+		}
+		else
+		{
+			gatherTexels(texelPtr);
 		}
 	}
 	else if(texelSize == 2)
@@ -991,9 +1106,9 @@ void SpirvEmitter::EmitImageRead(const ImageInstruction &instruction)
 		break;
 	case VK_FORMAT_R8G8B8A8_SRGB:
 	case VK_FORMAT_A8B8G8R8_SRGB_PACK32:
-		dst.move(0, sRGBtoLinear(SIMD::Float(packed[0] & SIMD::Int(0xFF)) * SIMD::Float(1.0f / 0xFF)));
-		dst.move(1, sRGBtoLinear(SIMD::Float((packed[0] >> 8) & SIMD::Int(0xFF)) * SIMD::Float(1.0f / 0xFF)));
-		dst.move(2, sRGBtoLinear(SIMD::Float((packed[0] >> 16) & SIMD::Int(0xFF)) * SIMD::Float(1.0f / 0xFF)));
+		dst.move(0, sRGB8toLinear(packed[0] & SIMD::Int(0xFF), routine->constants));
+		dst.move(1, sRGB8toLinear((packed[0] >> 8) & SIMD::Int(0xFF), routine->constants));
+		dst.move(2, sRGB8toLinear((packed[0] >> 16) & SIMD::Int(0xFF), routine->constants));
 		dst.move(3, SIMD::Float((packed[0] >> 24) & SIMD::Int(0xFF)) * SIMD::Float(1.0f / 0xFF));
 		break;
 	case VK_FORMAT_B8G8R8A8_UNORM:
@@ -1003,9 +1118,9 @@ void SpirvEmitter::EmitImageRead(const ImageInstruction &instruction)
 		dst.move(3, SIMD::Float((packed[0] >> 24) & SIMD::Int(0xFF)) * SIMD::Float(1.0f / 0xFF));
 		break;
 	case VK_FORMAT_B8G8R8A8_SRGB:
-		dst.move(0, sRGBtoLinear(SIMD::Float((packed[0] >> 16) & SIMD::Int(0xFF)) * SIMD::Float(1.0f / 0xFF)));
-		dst.move(1, sRGBtoLinear(SIMD::Float((packed[0] >> 8) & SIMD::Int(0xFF)) * SIMD::Float(1.0f / 0xFF)));
-		dst.move(2, sRGBtoLinear(SIMD::Float(packed[0] & SIMD::Int(0xFF)) * SIMD::Float(1.0f / 0xFF)));
+		dst.move(0, sRGB8toLinear((packed[0] >> 16) & SIMD::Int(0xFF), routine->constants));
+		dst.move(1, sRGB8toLinear((packed[0] >> 8) & SIMD::Int(0xFF), routine->constants));
+		dst.move(2, sRGB8toLinear(packed[0] & SIMD::Int(0xFF), routine->constants));
 		dst.move(3, SIMD::Float((packed[0] >> 24) & SIMD::Int(0xFF)) * SIMD::Float(1.0f / 0xFF));
 		break;
 	case VK_FORMAT_R8G8B8A8_UINT:
@@ -1508,10 +1623,29 @@ void SpirvEmitter::WriteImage(ImageInstructionSignature instruction, Pointer<Byt
 	// TODO(b/160531165): Provide scatter abstractions for various element sizes.
 	if(texelSize == 4 || texelSize == 8 || texelSize == 16)
 	{
-		for(auto i = 0; i < texelSize / 4; i++)
+		auto scatterTexels = [&](SIMD::Pointer texelPtr) {
+			for(auto i = 0; i < texelSize / 4; i++)
+			{
+				texelPtr.Store(packed[i], robustness, mask);
+				texelPtr += sizeof(float);
+			}
+		};
+
+		if(SIMD::Width == 4)
+		{
+			// Vector stores would overwrite the texels of inactive lanes, so all lanes must be written.
+			If(IsRowContiguous(texelPtr, texelSize) && !AnyFalse(mask))
+			{
+				StoreRowContiguousTexels(texelPtr, texelSize, packed);
+			}
+			Else
+			{
+				scatterTexels(texelPtr);
+			}
+		}
+		else
 		{
-			texelPtr.Store(packed[i], robustness, mask);
-			texelPtr += sizeof(float);
+			scatterTexels(texelPtr);
 		}
 	}
 	else if(texelSize == 2)
@@ -70,6 +70,14 @@ void SpirvEmitter::EmitLoad(InsnIterator insn)
 		auto &dst = createIntermediate(resultId, resultTy.componentCount);
 		shader.VisitMemoryObject(pointerId, false, [&](const Spirv::MemoryElement &el) {
 			auto p = GetElementPointer(ptr, el.offset, pointerTy.storageClass);
+
+			uint32_t value = 0;
+			if(pointerTy.storageClass == spv::StorageClassPushConstant && GetSpecializedPushConstant(p, value))
+			{
+				dst.move(el.index, SIMD::UInt(value));
+				return;
+			}
+
 			dst.move(el.index, p.Load<SIMD::Float>(robustness, activeLaneMask(), atomic, memoryOrder));
 		});
 
@@ -576,6 +584,23 @@ sw::SIMD::Pointer SpirvEmitter::GetElementPointer(sw::SIMD::Pointer structure, u
 	}
 }
 
+bool SpirvEmitter::GetSpecializedPushConstant(const SIMD::Pointer &ptr, uint32_t &value) const
+{
+	if(!routine->specializedPushConstants || !ptr.isBasePlusOffset || !ptr.hasStaticEqualOffsets())
+	{
+		return false;
+	}
+
+	int32_t offset = ptr.staticOffsets[0];
+	if(offset < 0 || offset + sizeof(uint32_t) > vk::MAX_PUSH_CONSTANT_SIZE)
+	{
+		return false;
+	}
+
+	memcpy(&value, routine->specializedPushConstants + offset, sizeof(uint32_t));
+	return true;
+}
+
 bool SpirvEmitter::IsStorageInterleavedByLane(spv::StorageClass storageClass)
 {
 	switch(storageClass)
@@ -33,6 +33,11 @@ VertexRoutine::VertexRoutine(
     , state(state)
     , spirvShader(spirvShader)
 {
+	if(state.specializedPushConstants)
+	{
+		routine.specializedPushConstants = state.pushConstants;
+	}
+
 	spirvShader->emitProlog(&routine);
 }
 
@@ -134,6 +139,13 @@ void VertexRoutine::computeClipFlags()
 		clipFlags |= maxY & Clipper::CLIP_TOP;
 		clipFlags |= minX & Clipper::CLIP_LEFT;
 		clipFlags |= minY & Clipper::CLIP_BOTTOM;
+
+		SIMD::Float guardBandX = SIMD::Float(*Pointer<Float>(data + OFFSET(DrawData, guardBandX))) * posW;
+		SIMD::Float guardBandY = SIMD::Float(*Pointer<Float>(data + OFFSET(DrawData, guardBandY))) * posW;
+		SIMD::Int outsideX = CmpLT(guardBandX, posX) | CmpNLE(-guardBandX, posX);
+		SIMD::Int outsideY = CmpLT(guardBandY, posY) | CmpNLE(-guardBandY, posY);
+		clipFlags |= (outsideX | outsideY) & Clipper::CLIP_GUARD_BAND;
+
 		if(state.depthClipEnable)
 		{
 			// If depthClipNegativeOneToOne is enabled, depth values are in [-1, 1] instead of [0, 1].
@@ -683,6 +695,12 @@ void VertexRoutine::writeCache(Pointer<Byte> &vertexCache, Pointer<UInt> &tagCac
 	*Pointer<Int>(vertexCache + sizeof(Vertex) * cacheIndex1 + OFFSET(Vertex, cullMask)) = -((cullMask >> 1) & 1);
 	*Pointer<Int>(vertexCache + sizeof(Vertex) * cacheIndex0 + OFFSET(Vertex, cullMask)) = -((cullMask >> 0) & 1);
 
+	// Varyings are not consumed when no fragment shader runs.
+	if(state.positionOnly)
+	{
+		return;
+	}
+
 	for(int i = 0; i < MAX_INTERFACE_COMPONENTS; i += 4)
 	{
 		if(spirvShader->outputs[i + 0].Type != Spirv::ATTRIBTYPE_UNUSED ||
@@ -715,7 +733,7 @@ void VertexRoutine::writeVertex(const Pointer<Byte> &vertex, Pointer<Byte> &cach
 	*Pointer<Int>(vertex + OFFSET(Vertex, cullMask)) = *Pointer<Int>(cacheEntry + OFFSET(Vertex, cullMask));
 	*Pointer<Int4>(vertex + OFFSET(Vertex, projected)) = *Pointer<Int4>(cacheEntry + OFFSET(Vertex, projected));
 
-	for(int i = 0; i < MAX_INTERFACE_COMPONENTS; i++)
+	for(int i = 0; i < MAX_INTERFACE_COMPONENTS && !state.positionOnly; i++)
 	{
 		if(spirvShader->outputs[i].Type != Spirv::ATTRIBTYPE_UNUSED)
 		{
@@ -62,15 +62,21 @@ __pragma(warning(push))
 #	include "llvm/Transforms/Scalar/DeadStoreElimination.h"
 #	include "llvm/Transforms/Scalar/EarlyCSE.h"
 #	include "llvm/Transforms/Scalar/LICM.h"
+#	include "llvm/Transforms/Scalar/LoopPassManager.h"
+#	include "llvm/Transforms/Scalar/LoopRotation.h"
+#	include "llvm/Transforms/Scalar/LoopUnrollPass.h"
 #	include "llvm/Transforms/Scalar/Reassociate.h"
 #	include "llvm/Transforms/Scalar/SCCP.h"
 #	include "llvm/Transforms/Scalar/SROA.h"
 #	include "llvm/Transforms/Scalar/SimplifyCFG.h"
+#	include "llvm/Transforms/Vectorize/SLPVectorizer.h"
 #else  // Legacy pass manager
+#	include "llvm/Analysis/TargetTransformInfo.h"
 #	include "llvm/IR/LegacyPassManager.h"
 #	include "llvm/Pass.h"
 #	include "llvm/Transforms/Coroutines.h"
 #	include "llvm/Transforms/IPO.h"
+#	include "llvm/Transforms/Vectorize.h"
 #endif
 
 #ifdef _MSC_VER
@@ -957,12 +963,34 @@ void JITBuilder::runPasses()
 	}
 #endif  // ENABLE_RR_DEBUG_INFO
 
+	// Levels 1 and 2 only run SROA and InstCombine. Further passes are enabled one
+	// at a time through the OptimizationPasses pragma, or all at once at level 3.
+	int optimizationPasses = (optimizationLevel >= 3) ? AllOptimizationPasses : getPragmaState(OptimizationPasses);
+	if(optimizationLevel == 0)
+	{
+		optimizationPasses = 0;
+	}
+
+	auto runs = [&](OptimizationPass pass) {
+		return (optimizationPasses & pass) != 0;
+	};
+
+	// The SLP vectorizer relies on the target's cost model to decide which
+	// scalar operations are worth packing, which requires a target machine.
+	std::unique_ptr<llvm::TargetMachine> targetMachine;
+	if(runs(SLPVectorization))
+	{
+		auto tm = JITGlobals::get()->getTargetMachineBuilder().createTargetMachine();
+		ASSERT_MSG(tm, "JITTargetMachineBuilder::createTargetMachine() failed");
+		targetMachine = std::move(tm.get());
+	}
+
 #if LLVM_VERSION_MAJOR >= 13  // New pass manager
 	llvm::LoopAnalysisManager lam;
 	llvm::FunctionAnalysisManager fam;
 	llvm::CGSCCAnalysisManager cgam;
 	llvm::ModuleAnalysisManager mam;
-	llvm::PassBuilder pb;
+	llvm::PassBuilder pb(targetMachine.get());
 
 	pb.registerModuleAnalyses(mam);
 	pb.registerCGSCCAnalyses(cgam);
@@ -982,9 +1010,64 @@ void JITBuilder::runPasses()
 	if(optimizationLevel > 0)
 	{
 		fpm.addPass(llvm::SROAPass(llvm::SROAOptions::PreserveCFG));
+
+		if(runs(EarlyCSE))
+		{
+			fpm.addPass(llvm::EarlyCSEPass(true /* UseMemorySSA */));
+		}
+
+		fpm.addPass(llvm::InstCombinePass());
+	}
+
+	if(runs(CFGSimplification))
+	{
+		fpm.addPass(llvm::SimplifyCFGPass());
+	}
+
+	if(runs(LoopRotation) || runs(LoopInvariantCodeMotion))
+	{
+		llvm::LoopPassManager lpm;
+		if(runs(LoopRotation))
+		{
+			lpm.addPass(llvm::LoopRotatePass());
+		}
+		if(runs(LoopInvariantCodeMotion))
+		{
+			lpm.addPass(llvm::LICMPass(llvm::LICMOptions()));
+		}
+		fpm.addPass(llvm::createFunctionToLoopPassAdaptor(std::move(lpm), true /* UseMemorySSA */));
+	}
+
+	if(runs(LoopUnrolling))
+	{
+		fpm.addPass(llvm::createFunctionToLoopPassAdaptor(llvm::LoopFullUnrollPass(optimizationLevel)));
+	}
+
+	if(runs(GlobalValueNumbering))
+	{
+		fpm.addPass(llvm::GVNPass());
+	}
+
+	if(runs(SLPVectorization))
+	{
+		fpm.addPass(llvm::SLPVectorizerPass());
+	}
+
+	if(runs(LoopUnrolling) || runs(GlobalValueNumbering) || runs(SLPVectorization))
+	{
 		fpm.addPass(llvm::InstCombinePass());
 	}
 
+	if(runs(DeadStoreElimination))
+	{
+		fpm.addPass(llvm::DSEPass());
+	}
+
+	if(runs(AggressiveDCE))
+	{
+		fpm.addPass(llvm::ADCEPass());
+	}
+
 	if(!fpm.isEmpty())
 	{
 		pm.addPass(llvm::createModuleToFunctionPassAdaptor(std::move(fpm)));
@@ -1015,12 +1098,68 @@ void JITBuilder::runPasses()
 		passManager.add(llvm::createCoroCleanupLegacyPass());
 	}
 
+	if(targetMachine)
+	{
+		passManager.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
+	}
+
 	if(optimizationLevel > 0)
 	{
 		passManager.add(llvm::createSROAPass());
+
+		if(runs(EarlyCSE))
+		{
+			passManager.add(llvm::createEarlyCSEPass(true /* UseMemorySSA */));
+		}
+
+		passManager.add(llvm::createInstructionCombiningPass());
+	}
+
+	if(runs(CFGSimplification))
+	{
+		passManager.add(llvm::createCFGSimplificationPass());
+	}
+
+	if(runs(LoopRotation))
+	{
+		passManager.add(llvm::createLoopRotatePass());
+	}
+
+	if(runs(LoopInvariantCodeMotion))
+	{
+		passManager.add(llvm::createLICMPass());
+	}
+
+	if(runs(LoopUnrolling))
+	{
+		passManager.add(llvm::createSimpleLoopUnrollPass(optimizationLevel));
+	}
+
+	if(runs(GlobalValueNumbering))
+	{
+		passManager.add(llvm::createGVNPass());
+	}
+
+	if(runs(SLPVectorization))
+	{
+		passManager.add(llvm::createSLPVectorizerPass());
+	}
+
+	if(runs(LoopUnrolling) || runs(GlobalValueNumbering) || runs(SLPVectorization))
+	{
 		passManager.add(llvm::createInstructionCombiningPass());
 	}
 
+	if(runs(DeadStoreElimination))
+	{
+		passManager.add(llvm::createDeadStoreEliminationPass());
+	}
+
+	if(runs(AggressiveDCE))
+	{
+		passManager.add(llvm::createAggressiveDCEPass());
+	}
+
 	if(__has_feature(memory_sanitizer) && msanInstrumentation)
 	{
 		llvm::MemorySanitizerOptions msanOpts(0 /* TrackOrigins */, false /* Recover */, false /* Kernel */);
@@ -3351,6 +3351,18 @@ RValue<Long> Ticks()
 	return RValue<Long>(V(jit->builder->CreateCall(rdtsc)));
 }
 
+void Prefetch(RValue<Pointer<Byte>> address)
+{
+	RR_DEBUG_INFO_UPDATE_LOC();
+	auto i32Ty = llvm::Type::getInt32Ty(*jit->context);
+	llvm::Function *prefetch = llvm::Intrinsic::getDeclaration(jit->module.get(), llvm::Intrinsic::prefetch, { T(Pointer<Byte>::type()) });
+
+	auto rw = llvm::ConstantInt::get(i32Ty, 0);         // Read
+	auto locality = llvm::ConstantInt::get(i32Ty, 3);   // Keep in all cache levels
+	auto cacheType = llvm::ConstantInt::get(i32Ty, 1);  // Data cache
+	jit->builder->CreateCall(prefetch, { V(address.value()), rw, locality, cacheType });
+}
+
 RValue<Pointer<Byte>> ConstantPointer(const void *ptr)
 {
 	RR_DEBUG_INFO_UPDATE_LOC();
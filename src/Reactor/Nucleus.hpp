@@ -220,6 +220,11 @@ public:
 		int allocas = 0;
 		int loads = 0;
 		int stores = 0;
+
+		// Number of instructions removed or moved by the global optimizations.
+		int foldedConstants = 0;
+		int eliminatedSubexpressions = 0;
+		int hoistedInvariants = 0;
 	};
 
 	using OptimizerCallback = void(const OptimizerReport *report);
@@ -16,7 +16,9 @@
 
 #include "src/IceCfg.h"
 #include "src/IceCfgNode.h"
+#include "src/IceLoopAnalyzer.h"
 
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 
@@ -40,6 +42,14 @@ private:
 	void propagateAlloca();
 	void performScalarReplacementOfAggregates();
 	void optimizeSingleBasicBlockLoadsStores();
+	void eliminateLoadsFollowingSingleStore();
+	void foldConstants();
+	void eliminateCommonSubexpressions();
+	void hoistLoopInvariants();
+
+	void computeDominators();
+	bool dominates(Ice::CfgNode *a, Ice::CfgNode *b) const;
+	Ice::Operand *foldArithmetic(Ice::InstArithmetic *arithmetic);
 
 	void replace(Ice::Inst *instruction, Ice::Operand *newValue);
 	void deleteInstruction(Ice::Inst *instruction);
@@ -53,6 +63,8 @@ private:
 	static bool isStore(const Ice::Inst &instruction);
 	static bool loadTypeMatchesStore(const Ice::Inst *load, const Ice::Inst *store);
 	static bool storeTypeMatchesStore(const Ice::Inst *store1, const Ice::Inst *store2);
+	static bool isPure(const Ice::Inst &instruction);
+	static bool isSafeToSpeculate(const Ice::Inst &instruction);
 
 	void collectDiagnostics();
 
@@ -69,6 +81,24 @@ private:
 		std::vector<Ice::Inst *> stores;
 	};
 
+	// Identifies the value computed by a side-effect free instruction.
+	struct Expression
+	{
+		Expression(const Ice::Inst &instruction);
+
+		bool operator==(const Expression &other) const;
+
+		struct Hash
+		{
+			size_t operator()(const Expression &expression) const;
+		};
+
+		Ice::Inst::InstKind kind;
+		uint32_t op;  // Arithmetic operation, cast kind, or comparison condition.
+		Ice::Type type;
+		Ice::Operand *operands[3] = {};
+	};
+
 	struct LoadStoreInst
 	{
 		LoadStoreInst(Ice::Inst *inst, bool isStore)
@@ -92,6 +122,15 @@ private:
 
 	std::vector<Ice::Operand *> operandsWithUses;
 
+	// Dominator tree, as pre-order and post-order numbers indexed by node index.
+	std::vector<uint32_t> dominatorPreOrder;
+	std::vector<uint32_t> dominatorPostOrder;
+	std::vector<Ice::CfgNode *> dominatorTreeOrder;  // Nodes in dominator tree pre-order.
+
+	int foldedConstants = 0;
+	int eliminatedSubexpressions = 0;
+	int hoistedInvariants = 0;
+
 	rr::Nucleus::OptimizerReport *report = nullptr;
 };
 
@@ -116,6 +155,21 @@ void Optimizer::run(Ice::Cfg *function)
 	// Iterate through basic blocks to propagate loads following stores.
 	optimizeSingleBasicBlockLoadsStores();
 
+	// The remaining passes don't modify the control flow, and share its dominator tree.
+	computeDominators();
+
+	// Propagate stores to the loads they dominate, across basic blocks.
+	eliminateLoadsFollowingSingleStore();
+
+	// Evaluate arithmetic on constants, and propagate the results.
+	foldConstants();
+
+	// Reuse values already computed in a dominating basic block.
+	eliminateCommonSubexpressions();
+
+	// Move arithmetic which doesn't depend on the loop out of it.
+	hoistLoopInvariants();
+
 	for(auto operand : operandsWithUses)
 	{
 		// Deletes the Uses instance on the operand
@@ -467,6 +521,576 @@ void Optimizer::optimizeSingleBasicBlockLoadsStores()
 	eliminateDeadCode();
 }
 
+// Replaces loads from stack variables which are stored to only once, with the
+// stored value, if the store dominates all the loads.
+void Optimizer::eliminateLoadsFollowingSingleStore()
+{
+	// Block and position within the block of each instruction.
+	struct Location
+	{
+		Ice::CfgNode *block;
+		size_t position;
+	};
+
+	std::unordered_map<const Ice::Inst *, Location> location;
+
+	for(Ice::CfgNode *block : function->getNodes())
+	{
+		size_t position = 0;
+
+		for(Ice::Inst &inst : block->getInsts())
+		{
+			if(!inst.isDeleted() && (isLoad(inst) || isStore(inst)))
+			{
+				location[&inst] = { block, position++ };
+			}
+		}
+	}
+
+	auto precedes = [&](const Ice::Inst *store, const Ice::Inst *load) {
+		auto storeLocation = location.find(store);
+		auto loadLocation = location.find(load);
+
+		// Instructions in unreachable blocks have no location.
+		if(storeLocation == location.end() || loadLocation == location.end())
+		{
+			return false;
+		}
+
+		if(storeLocation->second.block == loadLocation->second.block)
+		{
+			return storeLocation->second.position < loadLocation->second.position;
+		}
+
+		return dominates(storeLocation->second.block, loadLocation->second.block);
+	};
+
+	Ice::CfgNode *entryBlock = function->getEntryNode();
+
+	for(Ice::Inst &alloca : entryBlock->getInsts())
+	{
+		if(alloca.isDeleted())
+		{
+			continue;
+		}
+
+		if(!llvm::isa<Ice::InstAlloca>(alloca))
+		{
+			break;  // Allocas are all at the top
+		}
+
+		Ice::Operand *address = alloca.getDest();
+
+		if(!hasUses(address))
+		{
+			continue;
+		}
+
+		const auto &addressUses = *getUses(address);
+
+		if(!addressUses.areOnlyLoadStore() || addressUses.stores.size() != 1)
+		{
+			continue;
+		}
+
+		Ice::Inst *store = addressUses.stores[0];
+
+		bool allLoadsFollowStore = true;
+
+		for(Ice::Inst *load : addressUses.loads)
+		{
+			if(!loadTypeMatchesStore(load, store) || !precedes(store, load))
+			{
+				allLoadsFollowStore = false;
+				break;
+			}
+		}
+
+		if(!allLoadsFollowStore)
+		{
+			continue;
+		}
+
+		Uses loads = *getUses(address);  // Hard copy
+
+		for(Ice::Inst *load : loads)
+		{
+			if(load != store)
+			{
+				replace(load, store->getData());
+			}
+		}
+
+		// The remaining store is dead, and removes the alloca when deleted.
+		deleteInstruction(store);
+	}
+}
+
+// Evaluates integer arithmetic on constant operands and removes arithmetic with
+// an identity operand, replacing all uses with the result.
+void Optimizer::foldConstants()
+{
+	bool modified;
+	do
+	{
+		modified = false;
+		for(Ice::CfgNode *basicBlock : function->getNodes())
+		{
+			for(Ice::Inst &inst : basicBlock->getInsts())
+			{
+				if(inst.isDeleted())
+				{
+					continue;
+				}
+
+				auto *arithmetic = llvm::dyn_cast<Ice::InstArithmetic>(&inst);
+
+				if(!arithmetic)
+				{
+					continue;
+				}
+
+				Ice::Operand *value = foldArithmetic(arithmetic);
+
+				if(!value)
+				{
+					continue;
+				}
+
+				// Only substitute constants in operations known to accept them, to
+				// avoid e.g. turning computed addresses into absolute ones.
+				if(llvm::isa<Ice::Constant>(value) && hasUses(arithmetic->getDest()))
+				{
+					bool acceptsConstant = true;
+
+					for(Ice::Inst *use : *getUses(arithmetic->getDest()))
+					{
+						if(!isPure(*use) && !(isStore(*use) && use->getData() == arithmetic->getDest()))
+						{
+							acceptsConstant = false;
+							break;
+						}
+					}
+
+					if(!acceptsConstant)
+					{
+						continue;
+					}
+				}
+
+				replace(arithmetic, value);
+				foldedConstants++;
+				modified = true;
+			}
+		}
+	} while(modified);
+}
+
+// Returns the operand which the arithmetic instruction can be replaced with,
+// or nullptr if it can't be simplified.
+Ice::Operand *Optimizer::foldArithmetic(Ice::InstArithmetic *arithmetic)
+{
+	Ice::Type type = arithmetic->getDest()->getType();
+
+	if(type != Ice::IceType_i32 && type != Ice::IceType_i64)
+	{
+		return nullptr;
+	}
+
+	const bool is64 = (type == Ice::IceType_i64);
+	const int64_t minValue = is64 ? INT64_MIN : INT32_MIN;
+
+	auto constantValue = [](Ice::Operand *operand, int64_t &value) {
+		if(auto *constant = llvm::dyn_cast<Ice::ConstantInteger32>(operand))
+		{
+			value = constant->getValue();
+			return true;
+		}
+		else if(auto *constant = llvm::dyn_cast<Ice::ConstantInteger64>(operand))
+		{
+			value = constant->getValue();
+			return true;
+		}
+
+		return false;
+	};
+
+	Ice::Operand *lhs = arithmetic->getSrc(0);
+	Ice::Operand *rhs = arithmetic->getSrc(1);
+	int64_t a = 0;
+	int64_t b = 0;
+	const bool lhsConstant = constantValue(lhs, a);
+	const bool rhsConstant = constantValue(rhs, b);
+
+	auto constant = [&](uint64_t value) -> Ice::Operand * {
+		return is64 ? context->getConstantInt64(static_cast<int64_t>(value))
+		            : context->getConstantInt32(static_cast<int32_t>(static_cast<uint32_t>(value)));
+	};
+
+	if(lhsConstant && rhsConstant)
+	{
+		// Unsigned interpretations, for wrapping arithmetic and logical shifts.
+		const uint64_t ua = is64 ? static_cast<uint64_t>(a) : static_cast<uint32_t>(a);
+		const uint64_t ub = is64 ? static_cast<uint64_t>(b) : static_cast<uint32_t>(b);
+		const uint64_t bits = is64 ? 64 : 32;
+
+		switch(arithmetic->getOp())
+		{
+		case Ice::InstArithmetic::Add: return constant(ua + ub);
+		case Ice::InstArithmetic::Sub: return constant(ua - ub);
+		case Ice::InstArithmetic::Mul: return constant(ua * ub);
+		case Ice::InstArithmetic::And: return constant(ua & ub);
+		case Ice::InstArithmetic::Or: return constant(ua | ub);
+		case Ice::InstArithmetic::Xor: return constant(ua ^ ub);
+		case Ice::InstArithmetic::Shl: return (ub < bits) ? constant(ua << ub) : nullptr;
+		case Ice::InstArithmetic::Lshr: return (ub < bits) ? constant(ua >> ub) : nullptr;
+		case Ice::InstArithmetic::Ashr: return (ub < bits) ? constant(static_cast<uint64_t>(a >> ub)) : nullptr;
+		// Leave division by zero and overflowing division to trap at run time.
+		case Ice::InstArithmetic::Udiv: return (ub != 0) ? constant(ua / ub) : nullptr;
+		case Ice::InstArithmetic::Urem: return (ub != 0) ? constant(ua % ub) : nullptr;
+		case Ice::InstArithmetic::Sdiv: return (b != 0 && !(a == minValue && b == -1)) ? constant(static_cast<uint64_t>(a / b)) : nullptr;
+		case Ice::InstArithmetic::Srem: return (b != 0 && !(a == minValue && b == -1)) ? constant(static_cast<uint64_t>(a % b)) : nullptr;
+		default: return nullptr;
+		}
+	}
+
+	switch(arithmetic->getOp())
+	{
+	case Ice::InstArithmetic::Add:
+	case Ice::InstArithmetic::Or:
+	case Ice::InstArithmetic::Xor:
+		if(rhsConstant && b == 0) return lhs;
+		if(lhsConstant && a == 0) return rhs;
+		break;
+	case Ice::InstArithmetic::Sub:
+	case Ice::InstArithmetic::Shl:
+	case Ice::InstArithmetic::Lshr:
+	case Ice::InstArithmetic::Ashr:
+		if(rhsConstant && b == 0) return lhs;
+		break;
+	case Ice::InstArithmetic::Mul:
+		if(rhsConstant && b == 1) return lhs;
+		if(lhsConstant && a == 1) return rhs;
+		if((rhsConstant && b == 0) || (lhsConstant && a == 0)) return constant(0);
+		break;
+	case Ice::InstArithmetic::Udiv:
+	case Ice::InstArithmetic::Sdiv:
+		if(rhsConstant && b == 1) return lhs;
+		break;
+	case Ice::InstArithmetic::And:
+		if(rhsConstant && b == -1) return lhs;
+		if(lhsConstant && a == -1) return rhs;
+		if((rhsConstant && b == 0) || (lhsConstant && a == 0)) return constant(0);
+		break;
+	default:
+		break;
+	}
+
+	return nullptr;
+}
+
+// Replaces side-effect free instructions with an identical instruction in the
+// same or a dominating basic block.
+void Optimizer::eliminateCommonSubexpressions()
+{
+	struct Definition
+	{
+		Ice::Inst *inst;
+		Ice::CfgNode *block;
+	};
+
+	std::unordered_map<Expression, std::vector<Definition>, Expression::Hash> available;
+
+	// Visiting blocks in dominator tree pre-order guarantees that dominating
+	// definitions have been recorded before their potential replacements.
+	for(Ice::CfgNode *block : dominatorTreeOrder)
+	{
+		for(Ice::Inst &inst : block->getInsts())
+		{
+			if(inst.isDeleted() || !isPure(inst))
+			{
+				continue;
+			}
+
+			auto &definitions = available[Expression(inst)];
+			Ice::Inst *dominating = nullptr;
+
+			for(const Definition &definition : definitions)
+			{
+				if(!definition.inst->isDeleted() && dominates(definition.block, block))
+				{
+					dominating = definition.inst;
+					break;
+				}
+			}
+
+			if(dominating)
+			{
+				replace(&inst, dominating->getDest());
+				eliminatedSubexpressions++;
+			}
+			else
+			{
+				definitions.push_back({ &inst, block });
+			}
+		}
+	}
+}
+
+// Moves side-effect free arithmetic whose operands are all defined outside of
+// a loop into the loop's pre-header. Loads are not hoisted, since Subzero
+// doesn't distinguish volatile or atomic loads from regular ones.
+void Optimizer::hoistLoopInvariants()
+{
+	function->computeInOutEdges();
+
+	// Loops are sorted from largest to smallest, so invariants get hoisted out
+	// of an outer loop directly when possible.
+	Ice::CfgVector<Ice::Loop> loops = Ice::ComputeLoopInfo(function);
+
+	// The loop analysis accumulates the nest depth on nodes. Reset it for the
+	// backend to perform its own analysis.
+	for(Ice::CfgNode *node : function->getNodes())
+	{
+		node->setLoopNestDepth(0);
+	}
+
+	if(loops.empty())
+	{
+		return;
+	}
+
+	std::vector<Ice::CfgNode *> definitionBlock(function->getNumVariables(), nullptr);
+
+	for(Ice::CfgNode *node : function->getNodes())
+	{
+		for(Ice::Inst &inst : node->getInsts())
+		{
+			if(!inst.isDeleted() && inst.getDest())
+			{
+				definitionBlock[inst.getDest()->getIndex()] = node;
+			}
+		}
+	}
+
+	for(const Ice::Loop &loop : loops)
+	{
+		Ice::CfgNode *preHeader = loop.PreHeader;
+
+		// Only hoist into a pre-header which unconditionally branches into the loop.
+		if(!preHeader || preHeader->getOutEdges().size() != 1)
+		{
+			continue;
+		}
+
+		Ice::InstList &preHeaderInsts = preHeader->getInsts();
+		auto terminator = std::prev(preHeaderInsts.end());
+
+		bool modified;
+		do
+		{
+			modified = false;
+
+			// Iterate over the function's nodes rather than the loop body's
+			// unordered set, to retain a deterministic instruction order.
+			for(Ice::CfgNode *node : function->getNodes())
+			{
+				if(loop.Body.count(node->getIndex()) == 0)
+				{
+					continue;
+				}
+
+				Ice::InstList &insts = node->getInsts();
+
+				for(auto iterator = insts.begin(); iterator != insts.end();)
+				{
+					Ice::Inst &inst = *iterator++;
+
+					if(inst.isDeleted() || !isSafeToSpeculate(inst))
+					{
+						continue;
+					}
+
+					bool invariant = true;
+
+					for(Ice::SizeT i = 0; i < inst.getSrcSize(); i++)
+					{
+						if(auto *var = llvm::dyn_cast<Ice::Variable>(inst.getSrc(i)))
+						{
+							// Variables without a definition are function arguments.
+							Ice::CfgNode *block = definitionBlock[var->getIndex()];
+
+							if(block && loop.Body.count(block->getIndex()) != 0)
+							{
+								invariant = false;
+								break;
+							}
+						}
+					}
+
+					if(invariant)
+					{
+						insts.remove(inst);
+						preHeaderInsts.insert(terminator, &inst);
+						definitionBlock[inst.getDest()->getIndex()] = preHeader;
+						hoistedInvariants++;
+						modified = true;
+					}
+				}
+			}
+		} while(modified);
+	}
+}
+
+// Computes the dominator tree, using the algorithm from "A Simple, Fast
+// Dominance Algorithm" by Cooper, Harvey and Kennedy.
+void Optimizer::computeDominators()
+{
+	// Also prunes unreachable nodes.
+	function->computeInOutEdges();
+
+	const Ice::NodeList &nodes = function->getNodes();
+	const size_t count = nodes.size();
+
+	// Depth-first traversal to obtain the post-order of the nodes.
+	std::vector<Ice::CfgNode *> postOrder;
+	postOrder.reserve(count);
+	{
+		std::vector<bool> visited(count, false);
+		std::vector<std::pair<Ice::CfgNode *, size_t>> stack;  // Node and next successor to visit.
+
+		Ice::CfgNode *entry = function->getEntryNode();
+		visited[entry->getIndex()] = true;
+		stack.push_back({ entry, 0 });
+
+		while(!stack.empty())
+		{
+			Ice::CfgNode *node = stack.back().first;
+			size_t &next = stack.back().second;
+			const Ice::NodeList &successors = node->getOutEdges();
+
+			if(next < successors.size())
+			{
+				Ice::CfgNode *successor = successors[next++];
+
+				if(!visited[successor->getIndex()])
+				{
+					visited[successor->getIndex()] = true;
+					stack.push_back({ successor, 0 });
+				}
+			}
+			else
+			{
+				postOrder.push_back(node);
+				stack.pop_back();
+			}
+		}
+	}
+
+	assert(postOrder.size() == count);
+
+	std::vector<uint32_t> postOrderIndex(count);
+	for(uint32_t i = 0; i < count; i++)
+	{
+		postOrderIndex[postOrder[i]->getIndex()] = i;
+	}
+
+	// Immediate dominators, indexed by post-order index. The entry is last.
+	constexpr uint32_t undefined = ~0u;
+	std::vector<uint32_t> idom(count, undefined);
+	idom[count - 1] = count - 1;
+
+	bool changed;
+	do
+	{
+		changed = false;
+
+		// Visit in reverse post-order, skipping the entry.
+		for(uint32_t i = count - 1; i-- != 0;)
+		{
+			uint32_t newIdom = undefined;
+
+			for(Ice::CfgNode *predecessor : postOrder[i]->getInEdges())
+			{
+				uint32_t p = postOrderIndex[predecessor->getIndex()];
+
+				if(idom[p] == undefined)
+				{
+					continue;
+				}
+
+				if(newIdom == undefined)
+				{
+					newIdom = p;
+					continue;
+				}
+
+				// Walk up the tree to the common dominator.
+				uint32_t finger1 = p;
+				uint32_t finger2 = newIdom;
+				while(finger1 != finger2)
+				{
+					while(finger1 < finger2) finger1 = idom[finger1];
+					while(finger2 < finger1) finger2 = idom[finger2];
+				}
+
+				newIdom = finger1;
+			}
+
+			if(idom[i] != newIdom)
+			{
+				idom[i] = newIdom;
+				changed = true;
+			}
+		}
+	} while(changed);
+
+	// Number the dominator tree nodes in pre-order and post-order, so that
+	// dominance can be tested in constant time.
+	std::vector<std::vector<uint32_t>> children(count);
+	for(uint32_t i = count - 1; i-- != 0;)
+	{
+		children[idom[i]].push_back(i);
+	}
+
+	dominatorPreOrder.assign(count, 0);
+	dominatorPostOrder.assign(count, 0);
+	dominatorTreeOrder.clear();
+	dominatorTreeOrder.reserve(count);
+
+	uint32_t preNumber = 0;
+	uint32_t postNumber = 0;
+	std::vector<std::pair<uint32_t, size_t>> stack;  // Post-order index and next child to visit.
+	stack.push_back({ count - 1, 0 });
+	dominatorPreOrder[postOrder[count - 1]->getIndex()] = preNumber++;
+	dominatorTreeOrder.push_back(postOrder[count - 1]);
+
+	while(!stack.empty())
+	{
+		uint32_t node = stack.back().first;
+		size_t &next = stack.back().second;
+
+		if(next < children[node].size())
+		{
+			uint32_t child = children[node][next++];
+			dominatorPreOrder[postOrder[child]->getIndex()] = preNumber++;
+			dominatorTreeOrder.push_back(postOrder[child]);
+			stack.push_back({ child, 0 });
+		}
+		else
+		{
+			dominatorPostOrder[postOrder[node]->getIndex()] = postNumber++;
+			stack.pop_back();
+		}
+	}
+}
+
+bool Optimizer::dominates(Ice::CfgNode *a, Ice::CfgNode *b) const
+{
+	return dominatorPreOrder[a->getIndex()] <= dominatorPreOrder[b->getIndex()] &&
+	       dominatorPostOrder[b->getIndex()] <= dominatorPostOrder[a->getIndex()];
+}
+
 void Optimizer::analyzeUses(Ice::Cfg *function)
 {
 	for(Ice::CfgNode *basicBlock : function->getNodes())
@@ -753,6 +1377,42 @@ bool Optimizer::storeTypeMatchesStore(const Ice::Inst *store1, const Ice::Inst *
 	return true;
 }
 
+bool Optimizer::isPure(const Ice::Inst &instruction)
+{
+	switch(instruction.getKind())
+	{
+	case Ice::Inst::Arithmetic:
+	case Ice::Inst::Cast:
+	case Ice::Inst::ExtractElement:
+	case Ice::Inst::Fcmp:
+	case Ice::Inst::Icmp:
+	case Ice::Inst::InsertElement:
+	case Ice::Inst::Select:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool Optimizer::isSafeToSpeculate(const Ice::Inst &instruction)
+{
+	if(auto *arithmetic = llvm::dyn_cast<Ice::InstArithmetic>(&instruction))
+	{
+		switch(arithmetic->getOp())
+		{
+		case Ice::InstArithmetic::Udiv:
+		case Ice::InstArithmetic::Sdiv:
+		case Ice::InstArithmetic::Urem:
+		case Ice::InstArithmetic::Srem:
+			return false;  // May trap on division by zero.
+		default:
+			return true;
+		}
+	}
+
+	return isPure(instruction);
+}
+
 void Optimizer::collectDiagnostics()
 {
 	if(report)
@@ -782,9 +1442,67 @@ void Optimizer::collectDiagnostics()
 				}
 			}
 		}
+
+		report->foldedConstants = foldedConstants;
+		report->eliminatedSubexpressions = eliminatedSubexpressions;
+		report->hoistedInvariants = hoistedInvariants;
 	}
 }
 
+Optimizer::Expression::Expression(const Ice::Inst &instruction)
+    : kind(instruction.getKind())
+    , op(0)
+    , type(instruction.getDest()->getType())
+{
+	assert(instruction.getSrcSize() <= std::size(operands));
+
+	for(Ice::SizeT i = 0; i < instruction.getSrcSize(); i++)
+	{
+		operands[i] = instruction.getSrc(i);
+	}
+
+	if(auto *arithmetic = llvm::dyn_cast<Ice::InstArithmetic>(&instruction))
+	{
+		op = arithmetic->getOp();
+
+		// Canonicalize the operand order of commutative operations.
+		if(arithmetic->isCommutative() && std::less<Ice::Operand *>()(operands[1], operands[0]))
+		{
+			std::swap(operands[0], operands[1]);
+		}
+	}
+	else if(auto *cast = llvm::dyn_cast<Ice::InstCast>(&instruction))
+	{
+		op = cast->getCastKind();
+	}
+	else if(auto *icmp = llvm::dyn_cast<Ice::InstIcmp>(&instruction))
+	{
+		op = icmp->getCondition();
+	}
+	else if(auto *fcmp = llvm::dyn_cast<Ice::InstFcmp>(&instruction))
+	{
+		op = fcmp->getCondition();
+	}
+}
+
+bool Optimizer::Expression::operator==(const Expression &other) const
+{
+	return kind == other.kind && op == other.op && type == other.type &&
+	       std::equal(std::begin(operands), std::end(operands), std::begin(other.operands));
+}
+
+size_t Optimizer::Expression::Hash::operator()(const Expression &expression) const
+{
+	size_t hash = (static_cast<size_t>(expression.kind) << 16) ^ (static_cast<size_t>(expression.op) << 8) ^ static_cast<size_t>(expression.type);
+
+	for(Ice::Operand *operand : expression.operands)
+	{
+		hash = hash * 31 + std::hash<Ice::Operand *>()(operand);
+	}
+
+	return hash;
+}
+
 Optimizer::Uses *Optimizer::getUses(Ice::Operand *operand)
 {
 	Optimizer::Uses *uses = (Optimizer::Uses *)operand->Ice::Operand::getExternalData();
@@ -33,6 +33,7 @@ struct PragmaState
 	bool memorySanitizerInstrumentation = true;
 	bool initializeLocalVariables = false;
 	int optimizationLevel = 2;  // Default
+	int optimizationPasses = 0;
 };
 
 // The initialization of static thread-local data is not observed by MemorySanitizer
@@ -87,6 +88,9 @@ void Pragma(IntegerPragmaOption option, int value)
 	case OptimizationLevel:
 		state.optimizationLevel = value;
 		break;
+	case OptimizationPasses:
+		state.optimizationPasses = value;
+		break;
 	default:
 		UNSUPPORTED("Unknown integer pragma option %d", int(option));
 	}
@@ -116,6 +120,8 @@ int getPragmaState(IntegerPragmaOption option)
 	{
 	case OptimizationLevel:
 		return state.optimizationLevel;
+	case OptimizationPasses:
+		return state.optimizationPasses;
 	default:
 		UNSUPPORTED("Unknown integer pragma option %d", int(option));
 		return 0;
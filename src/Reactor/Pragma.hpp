@@ -27,7 +27,26 @@ enum BooleanPragmaOption
 
 enum IntegerPragmaOption
 {
-	OptimizationLevel,  // O0, O1, O2 (default), O3
+	OptimizationLevel,   // O0, O1, O2 (default), O3
+	OptimizationPasses,  // Bitwise OR of OptimizationPass flags
+};
+
+// Passes which the LLVM backend runs in addition to the default pipeline of
+// optimization levels 1 and 2, so their cost and benefit can be measured
+// one at a time. Optimization level 3 runs all of them.
+enum OptimizationPass
+{
+	EarlyCSE = 1 << 0,
+	CFGSimplification = 1 << 1,
+	LoopRotation = 1 << 2,
+	LoopInvariantCodeMotion = 1 << 3,
+	LoopUnrolling = 1 << 4,
+	GlobalValueNumbering = 1 << 5,
+	SLPVectorization = 1 << 6,
+	DeadStoreElimination = 1 << 7,
+	AggressiveDCE = 1 << 8,
+
+	AllOptimizationPasses = (1 << 9) - 1
 };
 
 void Pragma(BooleanPragmaOption option, bool enable);
@@ -2411,6 +2411,11 @@ public:
 
 RValue<Long> Ticks();
 
+// Prefetch hints that the memory at the given address will soon be read, so it
+// can be brought into the cache ahead of time. It never faults, even for invalid
+// addresses, and has no effect on backends which don't support prefetching.
+void Prefetch(RValue<Pointer<Byte>> address);
+
 }  // namespace rr
 
 /* Inline implementations */
@@ -4044,6 +4044,12 @@ RValue<Long> Ticks()
 	return Long(Int(0));
 }
 
+void Prefetch(RValue<Pointer<Byte>> address)
+{
+	RR_DEBUG_INFO_UPDATE_LOC();
+	// Subzero has no prefetch intrinsic. Since prefetching is only a hint, omitting it is valid.
+}
+
 RValue<Pointer<Byte>> ConstantPointer(const void *ptr)
 {
 	RR_DEBUG_INFO_UPDATE_LOC();
@@ -109,6 +109,26 @@ void *LinuxMemFd::mapReadWrite(size_t offset, size_t size)
 	return (addr == MAP_FAILED) ? nullptr : addr;
 }
 
+bool LinuxMemFd::mapPrivateFixed(void *addr, size_t offset, size_t size)
+{
+	void *result = ::mmap(addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd_,
+	                      static_cast<off_t>(offset));
+	return result != MAP_FAILED;
+}
+
+bool LinuxMemFd::mapSharedFixed(void *addr, size_t offset, size_t size)
+{
+	void *result = ::mmap(addr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_,
+	                      static_cast<off_t>(offset));
+	return result != MAP_FAILED;
+}
+
+bool LinuxMemFd::punchHole(size_t offset, size_t size)
+{
+	return ::fallocate(fd_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+	                   static_cast<off_t>(offset), static_cast<off_t>(size)) == 0;
+}
+
 bool LinuxMemFd::unmap(void *addr, size_t size)
 {
 	return ::munmap(addr, size) == 0;
@@ -57,6 +57,24 @@ public:
 	// on failure.
 	void *mapReadWrite(size_t offset, size_t size);
 
+	// Replace the |size| bytes of address space at |addr| with a private
+	// copy-on-write mapping of the region from |offset|. Writes through the
+	// mapping are not visible to other mappings and don't modify the region.
+	// |addr|, |offset| and |size| should be page-aligned. Returns false/errno
+	// on failure.
+	bool mapPrivateFixed(void *addr, size_t offset, size_t size);
+
+	// Replace the |size| bytes of address space at |addr| with a shared
+	// mapping of the region from |offset|, as returned by mapReadWrite().
+	// |addr|, |offset| and |size| should be page-aligned. Returns false/errno
+	// on failure.
+	bool mapSharedFixed(void *addr, size_t offset, size_t size);
+
+	// Release the pages backing |size| bytes of the region from |offset|,
+	// which then read as zeroes. Both |offset| and |size| should be
+	// page-aligned. Returns false/errno on failure.
+	bool punchHole(size_t offset, size_t size);
+
 	// Unmap a region segment starting at |addr| of |size| bytes.
 	// Both |addr| and |size| should be page-aligned. Returns true on success
 	// or false/errno on failure.
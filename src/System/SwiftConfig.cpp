@@ -109,6 +109,14 @@ Configuration readConfigurationFromFile()
 		config.affinityPolicy = Configuration::AffinityPolicy::AnyOf;
 	}
 
+	// Rasterizer flags.
+	config.guardBandSize = ini.getInteger<uint32_t>("Rasterizer", "GuardBandSize", 16384);
+	config.pushConstantSpecializationDraws = ini.getInteger<uint32_t>("Rasterizer", "PushConstantSpecializationDraws", 0);
+	config.enableVertexResultReuse = ini.getBoolean("Rasterizer", "EnableVertexResultReuse");
+
+	// Memory flags.
+	config.enableCopyOnWriteMemory = ini.getBoolean("Memory", "EnableCopyOnWrite");
+
 	// Profiling flags.
 	config.enableSpirvProfiling = ini.getBoolean("Profiler", "EnableSpirvProfiling");
 	config.spvProfilingReportPeriodMs = ini.getInteger<uint64_t>("Profiler", "SpirvProfilingReportPeriodMs");
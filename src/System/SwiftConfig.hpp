@@ -41,6 +41,26 @@ struct Configuration
 	uint64_t affinityMask = 0xFFFFFFFFFFFFFFFFu;
 	AffinityPolicy affinityPolicy = AffinityPolicy::AnyOf;
 
+	// -------- [Rasterizer] --------
+	// Extent in pixels of the guard band region. Triangles which cross the
+	// viewport sides but stay within it are rasterized without being clipped.
+	// A size of 0 disables the guard band.
+	uint32_t guardBandSize = 16384;
+
+	// Number of consecutive draws of a pipeline with unchanged push constants
+	// after which its vertex and pixel routines get specialized for the push
+	// constant values. A count of 0 disables the specialization.
+	uint32_t pushConstantSpecializationDraws = 0;
+
+	// Whether draws which shade the same vertices as an earlier draw of the
+	// same submission reuse its cached results instead of shading them again.
+	bool enableVertexResultReuse = false;
+
+	// -------- [Memory] --------
+	// Whether large device memory allocations are backed by memfd regions on
+	// Linux, so that large copies between them share pages copy-on-write.
+	bool enableCopyOnWriteMemory = false;
+
 	// -------- [Profiler] --------
 	// Whether SPIR-V profiling is enabled.
 	bool enableSpirvProfiling = false;
@@ -102,6 +102,8 @@ bool Buffer::canBindToMemory(DeviceMemory *pDeviceMemory) const
 void Buffer::bind(DeviceMemory *pDeviceMemory, VkDeviceSize pMemoryOffset)
 {
 	memory = pDeviceMemory->getOffsetPointer(pMemoryOffset);
+	deviceMemory = pDeviceMemory;
+	memoryOffset = pMemoryOffset;
 }
 
 void Buffer::copyFrom(const void *srcMemory, VkDeviceSize pSize, VkDeviceSize pOffset)
@@ -120,6 +122,15 @@ void Buffer::copyTo(void *dstMemory, VkDeviceSize pSize, VkDeviceSize pOffset) c
 
 void Buffer::copyTo(Buffer *dstBuffer, const VkBufferCopy2KHR &pRegion) const
 {
+	ASSERT((pRegion.size + pRegion.srcOffset) <= size);
+
+	// Large copies share the source pages with the destination until either gets written.
+	if(dstBuffer->deviceMemory->copyOnWriteFrom(deviceMemory, memoryOffset + pRegion.srcOffset,
+	                                            dstBuffer->memoryOffset + pRegion.dstOffset, pRegion.size))
+	{
+		return;
+	}
+
 	copyTo(dstBuffer->getOffsetPointer(pRegion.dstOffset), pRegion.size, pRegion.srcOffset);
 }
 
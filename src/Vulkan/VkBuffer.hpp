@@ -48,6 +48,8 @@ public:
 
 private:
 	void *memory = nullptr;
+	DeviceMemory *deviceMemory = nullptr;
+	VkDeviceSize memoryOffset = 0;
 	VkBufferCreateFlags flags = 0;
 	VkDeviceSize size = 0;
 	VkBufferUsageFlags usage = 0;
@@ -14,6 +14,7 @@
 
 #include "VkBufferView.hpp"
 #include "VkBuffer.hpp"
+#include "VkDescriptorSetLayout.hpp"
 #include "VkFormat.hpp"
 
 namespace vk {
@@ -32,6 +33,25 @@ BufferView::BufferView(const VkBufferViewCreateInfo *pCreateInfo, void *mem)
 	{
 		range = pCreateInfo->range;
 	}
+
+	if(mem)
+	{
+		sampledImageDescriptor = reinterpret_cast<SampledImageDescriptor *>(mem);
+		DescriptorSetLayout::WriteSampledImageDescriptor(sampledImageDescriptor, this);
+	}
+}
+
+void BufferView::destroy(const VkAllocationCallbacks *pAllocator)
+{
+	vk::freeHostMemory(sampledImageDescriptor, pAllocator);
+}
+
+size_t BufferView::ComputeRequiredAllocationSize(const VkBufferViewCreateInfo *pCreateInfo)
+{
+	// Only uniform texel buffer views need their descriptor contents.
+	bool uniformTexel = (vk::Cast(pCreateInfo->buffer)->getUsage() & VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT) != 0;
+
+	return uniformTexel ? sizeof(SampledImageDescriptor) : 0;
 }
 
 void *BufferView::getPointer() const
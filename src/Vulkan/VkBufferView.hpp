@@ -27,17 +27,22 @@ class BufferView : public Object<BufferView, VkBufferView>
 {
 public:
 	BufferView(const VkBufferViewCreateInfo *pCreateInfo, void *mem);
+	void destroy(const VkAllocationCallbacks *pAllocator);
 
-	static size_t ComputeRequiredAllocationSize(const VkBufferViewCreateInfo *pCreateInfo)
-	{
-		return 0;
-	}
+	static size_t ComputeRequiredAllocationSize(const VkBufferViewCreateInfo *pCreateInfo);
 
 	void *getPointer() const;
 	uint32_t getElementCount() const { return static_cast<uint32_t>(range / Format(format).bytes()); }
 	uint32_t getRangeInBytes() const { return static_cast<uint32_t>(range); }
 	VkFormat getFormat() const { return format; }
 
+	// Sampled image descriptor contents for uniform texel buffer views, built at creation.
+	const SampledImageDescriptor *getSampledImageDescriptor() const
+	{
+		ASSERT(sampledImageDescriptor);
+		return sampledImageDescriptor;
+	}
+
 	const Identifier id;
 
 private:
@@ -45,6 +50,7 @@ private:
 	VkFormat format;
 	VkDeviceSize offset;
 	VkDeviceSize range;
+	SampledImageDescriptor *sampledImageDescriptor = nullptr;
 };
 
 static inline BufferView *Cast(VkBufferView object)
@@ -77,6 +77,9 @@ public:
 		executionState.renderPassFramebuffer = framebuffer;
 		executionState.subpassIndex = 0;
 
+		// Subpass dependencies on external commands may make their writes visible.
+		executionState.renderer->invalidateVertexResults();
+
 		for(uint32_t i = 0; i < attachmentCount; i++)
 		{
 			framebuffer->setAttachment(attachments[i], i);
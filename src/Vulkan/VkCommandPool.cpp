@@ -45,8 +45,8 @@ VkResult CommandPool::allocateCommandBuffers(Device *device, VkCommandBufferLeve
 	for(uint32_t i = 0; i < commandBufferCount; i++)
 	{
 		// TODO(b/119409619): Allocate command buffers from the pool memory.
-		void *memory = vk::allocateHostMemory(sizeof(DispatchableCommandBuffer), vk::HOST_MEMORY_ALLOCATION_ALIGNMENT,
-		                                      NULL_ALLOCATION_CALLBACKS, DispatchableCommandBuffer::GetAllocationScope());
+		void *memory = vk::allocateObjectMemory(sizeof(DispatchableCommandBuffer), vk::HOST_MEMORY_ALLOCATION_ALIGNMENT,
+		                                        NULL_ALLOCATION_CALLBACKS, DispatchableCommandBuffer::GetAllocationScope());
 		ASSERT(memory);
 		DispatchableCommandBuffer *commandBuffer = new(memory) DispatchableCommandBuffer(device, level);
 		if(commandBuffer)
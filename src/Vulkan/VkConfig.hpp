@@ -102,6 +102,10 @@ constexpr int SUBPIXEL_PRECISION_BITS = SWIFTSHADER_LEGACY_PRECISION ? 4 : 8;
 constexpr float SUBPIXEL_PRECISION_FACTOR = static_cast<float>(1 << SUBPIXEL_PRECISION_BITS);
 constexpr int SUBPIXEL_PRECISION_MASK = 0xFFFFFFFF >> (32 - SUBPIXEL_PRECISION_BITS);
 
+// Edge setup multiplies subpixel deltas in 32-bit arithmetic, which limits the extent
+// of unclipped primitives, and therefore the guard band, to this many pixels.
+constexpr int MAX_GUARD_BAND_SIZE = 1 << (30 - 2 * SUBPIXEL_PRECISION_BITS);
+
 constexpr int MAX_VIEWPORTS = 16;
 
 // TODO: The heap size should be configured based on available RAM.
@@ -124,4 +128,8 @@ static_assert(MAX_MEMORY_ALLOCATION_SIZE <= 0x80000000ull, "maxMemoryAllocationS
 #	define SWIFTSHADER_EXTERNAL_MEMORY_OPAQUE_FD 1
 #endif
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#	define SWIFTSHADER_COPY_ON_WRITE_MEMORY 1
+#endif
+
 #endif  // VK_CONFIG_HPP_
@@ -25,6 +25,7 @@
 
 namespace vk {
 
+class BufferView;
 class DescriptorSet;
 class Device;
 
@@ -106,6 +107,10 @@ public:
 
 	static void WriteDescriptorSet(Device *device, DescriptorSet *dstSet, const VkDescriptorUpdateTemplateEntry &entry, const char *src);
 
+	// Writes the sampled image descriptor contents which only depend on the view.
+	static void WriteSampledImageDescriptor(SampledImageDescriptor *sampledImage, ImageView *imageView);
+	static void WriteSampledImageDescriptor(SampledImageDescriptor *sampledImage, const BufferView *bufferView);
+
 	void initialize(DescriptorSet *descriptorSet, uint32_t variableDescriptorCount);
 
 	// Returns the total size of the descriptor set in bytes.
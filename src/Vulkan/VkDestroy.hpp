@@ -63,7 +63,7 @@ inline void destroy(VkT vkObject, const VkAllocationCallbacks *pAllocator)
 		// object may not point to the same pointer as vkObject, for dispatchable objects,
 		// for example, so make sure to deallocate based on the vkObject pointer, which
 		// should always point to the beginning of the allocated memory
-		vk::freeHostMemory(vkObject, pAllocator);
+		vk::freeObjectMemory(vkObject, pAllocator);
 	}
 }
 
@@ -80,7 +80,7 @@ inline void release(VkT vkObject, const VkAllocationCallbacks *pAllocator)
 			// object may not point to the same pointer as vkObject, for dispatchable objects,
 			// for example, so make sure to deallocate based on the vkObject pointer, which
 			// should always point to the beginning of the allocated memory
-			vk::freeHostMemory(vkObject, pAllocator);
+			vk::freeObjectMemory(vkObject, pAllocator);
 		}
 	}
 }
@@ -80,6 +80,10 @@ struct OpaqueFdAllocateInfo
 #	include "VkDeviceMemoryExternalFuchsia.hpp"
 #endif
 
+#if SWIFTSHADER_COPY_ON_WRITE_MEMORY
+#	include "VkDeviceMemoryCopyOnWriteLinux.hpp"
+#endif
+
 namespace vk {
 
 VkResult DeviceMemory::Allocate(const VkAllocationCallbacks *pAllocator, const VkMemoryAllocateInfo *pAllocateInfo, VkDeviceMemory *pMemory, Device *device)
@@ -137,6 +141,12 @@ VkResult DeviceMemory::Allocate(const VkAllocationCallbacks *pAllocator, const V
 	{
 		return ExternalMemoryHost::Create(pAllocator, &allocateInfo, pMemory, extendedAllocationInfo, device);
 	}
+#if SWIFTSHADER_COPY_ON_WRITE_MEMORY
+	if(CopyOnWriteMemory::SupportsAllocateInfo(&allocateInfo))
+	{
+		return CopyOnWriteMemory::Create(pAllocator, &allocateInfo, pMemory, extendedAllocationInfo, device);
+	}
+#endif
 
 	return vk::DeviceMemoryInternal::Create(pAllocator, &allocateInfo, pMemory, extendedAllocationInfo, device);
 }
@@ -90,6 +90,12 @@ public:
 	bool checkExternalMemoryHandleType(
 	    VkExternalMemoryHandleTypeFlags supportedExternalMemoryHandleType) const;
 
+	// Copies |size| bytes at |srcOffset| of |src| to |dstOffset| of this memory by sharing
+	// the underlying pages until either side writes to them. Returns false without copying
+	// anything when the memories or the ranges don't allow sharing pages.
+	virtual bool copyOnWriteFrom(DeviceMemory *src, VkDeviceSize srcOffset, VkDeviceSize dstOffset, VkDeviceSize size) { return false; }
+	virtual bool supportsCopyOnWrite() const { return false; }
+
 	// Some external device memories, such as Android hardware buffers, store per-plane properties.
 	virtual bool hasExternalImagePlanes() const { return false; }
 	virtual int externalImageRowPitchBytes(VkImageAspectFlagBits aspect) const { return 0; }
@@ -0,0 +1,227 @@
+// Copyright 2024 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "VkDeviceMemory.hpp"
+
+#include "System/Debug.hpp"
+#include "System/Linux/MemFd.hpp"
+#include "System/Math.hpp"
+#include "System/Memory.hpp"
+#include "System/SwiftConfig.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <errno.h>
+#include <string.h>
+
+// Device memory backed by a memfd region, so that large copies between such memories
+// can share pages copy-on-write instead of moving the bytes.
+//
+// A copy maps both the source and the destination range privately onto the source's
+// file pages. Writes through private mappings go to new anonymous pages, so the file
+// pages keep holding the copied snapshot. As privately mapped ranges no longer reflect
+// their own file, they can't be the source of further page sharing.
+class CopyOnWriteMemory : public vk::DeviceMemory, public vk::ObjectBase<CopyOnWriteMemory, VkDeviceMemory>
+{
+public:
+	// Smaller allocations and copies are not worth a file descriptor and remapping.
+	static constexpr VkDeviceSize MinCopyOnWriteSize = 1024 * 1024;
+
+	// Limits the file descriptors held open by device memory. Further allocations
+	// use regular memory.
+	static constexpr int MaxMemFds = 64;
+
+	static bool SupportsAllocateInfo(const VkMemoryAllocateInfo *pAllocateInfo)
+	{
+		return sw::getConfiguration().enableCopyOnWriteMemory &&
+		       (pAllocateInfo->allocationSize >= MinCopyOnWriteSize);
+	}
+
+	explicit CopyOnWriteMemory(const VkMemoryAllocateInfo *pCreateInfo, void *mem, const vk::DeviceMemory::ExtendedAllocationInfo &extendedAllocationInfo, vk::Device *pDevice)
+	    : vk::DeviceMemory(pCreateInfo, extendedAllocationInfo, pDevice)
+	    , mappedSize(sw::align(static_cast<size_t>(allocationSize), static_cast<unsigned int>(sw::memoryPageSize())))
+	{
+	}
+
+	~CopyOnWriteMemory()
+	{
+		closeMemFd();
+	}
+
+	VkResult allocateBuffer() override
+	{
+		// Failing to get a memfd, e.g. when out of file descriptors, only loses page sharing.
+		if(++liveMemFds > MaxMemFds)
+		{
+			liveMemFds--;
+			return vk::DeviceMemory::allocateBuffer();
+		}
+
+		static std::atomic<int> counter(0);
+		char name[48];
+		snprintf(name, sizeof(name), "SwiftShader.CopyOnWriteMemory.%d", ++counter);
+
+		if(!memfd.allocate(name, mappedSize))
+		{
+			TRACE("memfd.allocate() returned %s", strerror(errno));
+			liveMemFds--;
+			return vk::DeviceMemory::allocateBuffer();
+		}
+
+		buffer = memfd.mapReadWrite(0, mappedSize);
+		if(!buffer)
+		{
+			closeMemFd();
+			return vk::DeviceMemory::allocateBuffer();
+		}
+
+		return VK_SUCCESS;
+	}
+
+	void freeBuffer() override
+	{
+		if(!memfd.isValid())
+		{
+			vk::DeviceMemory::freeBuffer();
+			return;
+		}
+
+		memfd.unmap(buffer, mappedSize);
+		closeMemFd();
+		buffer = nullptr;
+	}
+
+	bool supportsCopyOnWrite() const override
+	{
+		return memfd.isValid();
+	}
+
+	bool copyOnWriteFrom(vk::DeviceMemory *src, VkDeviceSize srcOffset, VkDeviceSize dstOffset, VkDeviceSize size) override
+	{
+		if((src == this) || !supportsCopyOnWrite() || !src->supportsCopyOnWrite())
+		{
+			return false;
+		}
+
+		// Pages can only be shared when both ranges start at the same offset within a page.
+		// Leading and trailing partial pages are copied.
+		const VkDeviceSize pageSize = sw::memoryPageSize();
+		if((srcOffset % pageSize) != (dstOffset % pageSize))
+		{
+			return false;
+		}
+
+		const VkDeviceSize head = std::min((pageSize - (dstOffset % pageSize)) % pageSize, size);
+		const VkDeviceSize sharedSize = ((size - head) / pageSize) * pageSize;
+		const VkDeviceSize tail = size - head - sharedSize;
+		const VkDeviceSize srcPages = srcOffset + head;
+		const VkDeviceSize dstPages = dstOffset + head;
+
+		if(sharedSize < MinCopyOnWriteSize)
+		{
+			return false;
+		}
+
+		CopyOnWriteMemory *source = static_cast<CopyOnWriteMemory *>(src);
+		std::scoped_lock lock(source->privateRangesMutex, privateRangesMutex);
+
+		if(source->overlapsPrivateRange(srcPages, sharedSize))
+		{
+			return false;
+		}
+
+		// Remapping keeps the source contents, since its shared mapping was backed by these file pages.
+		// A failed MAP_FIXED mmap() may already have unmapped the range, so the shared mapping is
+		// restored before falling back to copying.
+		if(!source->memfd.mapPrivateFixed(source->getOffsetPointer(srcPages), srcPages, sharedSize))
+		{
+			TRACE("mmap() returned %s", strerror(errno));
+			source->restoreSharedMapping(srcPages, sharedSize);
+			return false;
+		}
+		source->addPrivateRange(srcPages, sharedSize);
+
+		// The destination range gets overwritten by the fallback copy, so its previous contents
+		// don't need to survive a failure.
+		if(!source->memfd.mapPrivateFixed(getOffsetPointer(dstPages), srcPages, sharedSize))
+		{
+			TRACE("mmap() returned %s", strerror(errno));
+			restoreSharedMapping(dstPages, sharedSize);
+			return false;
+		}
+
+		// File pages which were only mapped by the replaced shared mapping are unused now.
+		if(!overlapsPrivateRange(dstPages, sharedSize))
+		{
+			memfd.punchHole(dstPages, sharedSize);
+		}
+		addPrivateRange(dstPages, sharedSize);
+
+		memcpy(getOffsetPointer(dstOffset), source->getOffsetPointer(srcOffset), head);
+		memcpy(getOffsetPointer(dstPages + sharedSize), source->getOffsetPointer(srcPages + sharedSize), tail);
+
+		return true;
+	}
+
+private:
+	void closeMemFd()
+	{
+		if(memfd.isValid())
+		{
+			memfd.close();
+			liveMemFds--;
+		}
+	}
+
+	void restoreSharedMapping(VkDeviceSize offset, VkDeviceSize size)
+	{
+		if(!memfd.mapSharedFixed(getOffsetPointer(offset), offset, size))
+		{
+			sw::abort("Failed to restore the mapping of device memory: %s", strerror(errno));
+		}
+	}
+
+	bool overlapsPrivateRange(VkDeviceSize offset, VkDeviceSize size) const
+	{
+		return std::any_of(privateRanges.begin(), privateRanges.end(), [&](const std::pair<VkDeviceSize, VkDeviceSize> &range) {
+			return (offset < range.second) && (range.first < offset + size);
+		});
+	}
+
+	void addPrivateRange(VkDeviceSize offset, VkDeviceSize size)
+	{
+		// Repeated copies to the same destination don't grow the list.
+		for(const auto &range : privateRanges)
+		{
+			if((range.first <= offset) && (offset + size <= range.second))
+			{
+				return;
+			}
+		}
+
+		privateRanges.emplace_back(offset, offset + size);
+	}
+
+	static inline std::atomic<int> liveMemFds{ 0 };
+
+	const size_t mappedSize;
+	LinuxMemFd memfd;
+
+	std::mutex privateRangesMutex;
+	std::vector<std::pair<VkDeviceSize, VkDeviceSize>> privateRanges;  // [begin, end) mapped privately
+};
@@ -24,6 +24,7 @@
 #include "Device/BC_Decoder.hpp"
 #include "Device/Blitter.hpp"
 #include "Device/ETC_Decoder.hpp"
+#include "System/Math.hpp"
 
 #ifdef __ANDROID__
 #	include <vndk/hardware_buffer.h>
@@ -31,6 +32,7 @@
 #	include "VkDeviceMemoryExternalAndroid.hpp"
 #endif
 
+#include <algorithm>
 #include <cstring>
 
 namespace {
@@ -196,6 +198,7 @@ Image::Image(const VkImageCreateInfo *pCreateInfo, void *mem, Device *device)
     , samples(pCreateInfo->samples)
     , tiling(pCreateInfo->tiling)
     , usage(pCreateInfo->usage)
+    , stencilUsage(pCreateInfo->usage)
 {
 	if(format.isCompressed())
 	{
@@ -209,6 +212,12 @@ Image::Image(const VkImageCreateInfo *pCreateInfo, void *mem, Device *device)
 	{
 		supportedExternalMemoryHandleTypes = externalInfo->handleTypes;
 	}
+
+	const auto *stencilUsageInfo = GetExtendedStruct<VkImageStencilUsageCreateInfo>(pCreateInfo->pNext, VK_STRUCTURE_TYPE_IMAGE_STENCIL_USAGE_CREATE_INFO);
+	if(stencilUsageInfo)
+	{
+		stencilUsage = stencilUsageInfo->stencilUsage;
+	}
 }
 
 void Image::destroy(const VkAllocationCallbacks *pAllocator)
@@ -398,6 +407,15 @@ void Image::getSubresourceLayout(const VkImageSubresource *pSubresource, VkSubre
 
 void Image::copyTo(Image *dstImage, const VkImageCopy2KHR &region) const
 {
+	// Whole image copies between identical layouts share the source pages with the
+	// destination until either gets written.
+	if(isWholeImageCopy(dstImage, region) &&
+	   dstImage->deviceMemory->copyOnWriteFrom(deviceMemory, memoryOffset, dstImage->memoryOffset, getStorageSize(format.getAspects())))
+	{
+		dstImage->contentsChanged(ImageSubresourceRange(region.dstSubresource));
+		return;
+	}
+
 	static constexpr VkImageAspectFlags CombinedDepthStencilAspects =
 	    VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
 	if((region.srcSubresource.aspectMask == CombinedDepthStencilAspects) &&
@@ -417,6 +435,34 @@ void Image::copyTo(Image *dstImage, const VkImageCopy2KHR &region) const
 	copySingleAspectTo(dstImage, region);
 }
 
+bool Image::isWholeImageCopy(const Image *dstImage, const VkImageCopy2KHR &region) const
+{
+	// Images with a single mip level and the same creation parameters have the same memory layout.
+	bool identicalLayout = (mipLevels == 1) && (dstImage->mipLevels == 1) &&
+	                       (imageType == dstImage->imageType) &&
+	                       (static_cast<VkFormat>(format) == static_cast<VkFormat>(dstImage->format)) &&
+	                       (extent.width == dstImage->extent.width) &&
+	                       (extent.height == dstImage->extent.height) &&
+	                       (extent.depth == dstImage->extent.depth) &&
+	                       (arrayLayers == dstImage->arrayLayers) &&
+	                       (samples == dstImage->samples) &&
+	                       (flags == dstImage->flags) &&
+	                       !decompressedImage && !dstImage->decompressedImage &&
+	                       !deviceMemory->hasExternalImagePlanes() &&
+	                       !dstImage->deviceMemory->hasExternalImagePlanes();
+
+	return identicalLayout &&
+	       (region.srcSubresource.aspectMask == format.getAspects()) &&
+	       (region.dstSubresource.aspectMask == format.getAspects()) &&
+	       (region.srcSubresource.baseArrayLayer == 0) && (region.srcSubresource.layerCount == arrayLayers) &&
+	       (region.dstSubresource.baseArrayLayer == 0) && (region.dstSubresource.layerCount == arrayLayers) &&
+	       (region.srcOffset.x == 0) && (region.srcOffset.y == 0) && (region.srcOffset.z == 0) &&
+	       (region.dstOffset.x == 0) && (region.dstOffset.y == 0) && (region.dstOffset.z == 0) &&
+	       (region.extent.width == extent.width) &&
+	       (region.extent.height == extent.height) &&
+	       (region.extent.depth == extent.depth);
+}
+
 void Image::copySingleAspectTo(Image *dstImage, const VkImageCopy2KHR &region) const
 {
 	// Image copy does not perform any conversion, it simply copies memory from
@@ -583,7 +629,12 @@ void Image::copySingleAspectTo(Image *dstImage, const VkImageCopy2KHR &region) c
 		dstLayer += dstLayerPitch;
 	}
 
-	dstImage->contentsChanged(ImageSubresourceRange(region.dstSubresource));
+	// The copied blocks, in texels of the destination format.
+	VkRect2D dstRect = {
+		{ region.dstOffset.x, region.dstOffset.y },
+		{ copyExtent.width * dstFormat.blockWidth(), copyExtent.height * dstFormat.blockHeight() }
+	};
+	dstImage->contentsChanged(ImageSubresourceRange(region.dstSubresource), DIRECT_MEMORY_ACCESS, &dstRect);
 }
 
 void Image::copy(const void *srcCopyMemory,
@@ -670,7 +721,11 @@ void Image::copy(const void *srcCopyMemory,
 
 	if(memoryIsSource)
 	{
-		contentsChanged(ImageSubresourceRange(imageSubresource));
+		VkRect2D rect = {
+			{ imageCopyOffset.x, imageCopyOffset.y },
+			{ imageCopyExtent.width, imageCopyExtent.height }
+		};
+		contentsChanged(ImageSubresourceRange(imageSubresource), DIRECT_MEMORY_ACCESS, &rect);
 	}
 }
 
@@ -1128,7 +1183,7 @@ bool Image::requiresPreprocessing() const
 	return isCubeCompatible() || decompressedImage;
 }
 
-void Image::contentsChanged(const VkImageSubresourceRange &subresourceRange, ContentsChangedContext contentsChangedContext)
+void Image::contentsChanged(const VkImageSubresourceRange &subresourceRange, ContentsChangedContext contentsChangedContext, const VkRect2D *dirtyRect)
 {
 	// If this function is called after (possibly) writing to this image from a shader,
 	// this must have the VK_IMAGE_USAGE_STORAGE_BIT set for the write operation to be
@@ -1149,6 +1204,12 @@ void Image::contentsChanged(const VkImageSubresourceRange &subresourceRange, Con
 	uint32_t lastLayer = getLastLayerIndex(subresourceRange);
 	uint32_t lastMipLevel = getLastMipLevel(subresourceRange);
 
+	// The rectangle is only meaningful for the mip level it was given in.
+	if(lastMipLevel != subresourceRange.baseMipLevel)
+	{
+		dirtyRect = nullptr;
+	}
+
 	VkImageSubresource subresource = {
 		subresourceRange.aspectMask,
 		subresourceRange.baseMipLevel,
@@ -1164,11 +1225,56 @@ void Image::contentsChanged(const VkImageSubresourceRange &subresourceRange, Con
 		    subresource.mipLevel <= lastMipLevel;
 		    subresource.mipLevel++)
 		{
-			dirtySubresources.insert(subresource);
+			VkRect2D rect = getDirtyRect(subresource, dirtyRect);
+
+			auto it = dirtySubresources.find(subresource);
+			if(it == dirtySubresources.end())
+			{
+				dirtySubresources.emplace(subresource, rect);
+			}
+			else
+			{
+				// Grow the dirty rectangle to the bounds of both changes.
+				VkRect2D &bounds = it->second;
+				int32_t x1 = std::max(bounds.offset.x + static_cast<int32_t>(bounds.extent.width), rect.offset.x + static_cast<int32_t>(rect.extent.width));
+				int32_t y1 = std::max(bounds.offset.y + static_cast<int32_t>(bounds.extent.height), rect.offset.y + static_cast<int32_t>(rect.extent.height));
+				bounds.offset.x = std::min(bounds.offset.x, rect.offset.x);
+				bounds.offset.y = std::min(bounds.offset.y, rect.offset.y);
+				bounds.extent.width = x1 - bounds.offset.x;
+				bounds.extent.height = y1 - bounds.offset.y;
+			}
 		}
 	}
 }
 
+VkRect2D Image::getDirtyRect(const VkImageSubresource &subresource, const VkRect2D *dirtyRect) const
+{
+	VkExtent3D mipLevelExtent = getMipLevelExtent(static_cast<VkImageAspectFlagBits>(subresource.aspectMask), subresource.mipLevel);
+
+	if(!dirtyRect)
+	{
+		return { { 0, 0 }, { mipLevelExtent.width, mipLevelExtent.height } };
+	}
+
+	// Compressed blocks get decoded as a whole, so round out to block boundaries.
+	int32_t blockWidth = format.blockWidth();
+	int32_t blockHeight = format.blockHeight();
+	int32_t x0 = (dirtyRect->offset.x / blockWidth) * blockWidth;
+	int32_t y0 = (dirtyRect->offset.y / blockHeight) * blockHeight;
+	int32_t x1 = std::min(sw::align(dirtyRect->offset.x + static_cast<int32_t>(dirtyRect->extent.width), blockWidth), static_cast<int32_t>(mipLevelExtent.width));
+	int32_t y1 = std::min(sw::align(dirtyRect->offset.y + static_cast<int32_t>(dirtyRect->extent.height), blockHeight), static_cast<int32_t>(mipLevelExtent.height));
+
+	return { { x0, y0 }, { static_cast<uint32_t>(std::max(x1 - x0, 0)), static_cast<uint32_t>(std::max(y1 - y0, 0)) } };
+}
+
+// Borders of cube faces are copied from the outermost texels of the adjacent faces.
+static bool touchesEdges(const VkRect2D &rect, const VkExtent3D &extent)
+{
+	return (rect.offset.x == 0) || (rect.offset.y == 0) ||
+	       (rect.offset.x + rect.extent.width >= extent.width) ||
+	       (rect.offset.y + rect.extent.height >= extent.height);
+}
+
 void Image::prepareForSampling(const VkImageSubresourceRange &subresourceRange) const
 {
 	// If this isn't a cube or a compressed image, there's nothing to do
@@ -1207,7 +1313,7 @@ void Image::prepareForSampling(const VkImageSubresourceRange &subresourceRange)
 				auto it = dirtySubresources.find(subresource);
 				if(it != dirtySubresources.end())
 				{
-					decompress(subresource);
+					decompress(subresource, it->second);
 				}
 			}
 		}
@@ -1220,23 +1326,31 @@ void Image::prepareForSampling(const VkImageSubresourceRange &subresourceRange)
 		    subresource.mipLevel <= lastMipLevel;
 		    subresource.mipLevel++)
 		{
-			for(subresource.arrayLayer = subresourceRange.baseArrayLayer;
-			    subresource.arrayLayer <= lastLayer;
-			    subresource.arrayLayer++)
-			{
-				auto it = dirtySubresources.find(subresource);
-				if(it != dirtySubresources.end())
-				{
-					// Since cube faces affect each other's borders, we update all 6 layers.
+			VkExtent3D mipLevelExtent = getMipLevelExtent(static_cast<VkImageAspectFlagBits>(subresource.aspectMask), subresource.mipLevel);
 
-					subresource.arrayLayer -= subresource.arrayLayer % 6;  // Round down to a multiple of 6.
+			// Since cube faces affect each other's borders, we update all 6 layers.
+			uint32_t firstCubeLayer = subresourceRange.baseArrayLayer - (subresourceRange.baseArrayLayer % 6);
 
-					if(subresource.arrayLayer + 5 <= lastLayer)
+			for(uint32_t cubeLayer = firstCubeLayer; cubeLayer + 5 <= lastLayer; cubeLayer += 6)
+			{
+				bool edgesChanged = false;
+
+				for(subresource.arrayLayer = std::max(cubeLayer, subresourceRange.baseArrayLayer);
+				    subresource.arrayLayer <= cubeLayer + 5;
+				    subresource.arrayLayer++)
+				{
+					auto it = dirtySubresources.find(subresource);
+					if(it != dirtySubresources.end() && touchesEdges(it->second, mipLevelExtent))
 					{
-						device->getBlitter()->updateBorders(decompressedImage ? decompressedImage : this, subresource);
+						edgesChanged = true;
+						break;
 					}
+				}
 
-					subresource.arrayLayer += 5;  // Together with the loop increment, advances to the next cube.
+				if(edgesChanged)
+				{
+					subresource.arrayLayer = cubeLayer;
+					device->getBlitter()->updateBorders(decompressedImage ? decompressedImage : this, subresource);
 				}
 			}
 		}
@@ -1260,7 +1374,7 @@ void Image::prepareForSampling(const VkImageSubresourceRange &subresourceRange)
 	}
 }
 
-void Image::decompress(const VkImageSubresource &subresource) const
+void Image::decompress(const VkImageSubresource &subresource, const VkRect2D &rect) const
 {
 	switch(format)
 	{
@@ -1274,7 +1388,7 @@ void Image::decompress(const VkImageSubresource &subresource) const
 	case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
 	case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
 	case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
-		decodeETC2(subresource);
+		decodeETC2(subresource, rect);
 		break;
 	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
 	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
@@ -1292,7 +1406,7 @@ void Image::decompress(const VkImageSubresource &subresource) const
 	case VK_FORMAT_BC6H_SFLOAT_BLOCK:
 	case VK_FORMAT_BC7_UNORM_BLOCK:
 	case VK_FORMAT_BC7_SRGB_BLOCK:
-		decodeBC(subresource);
+		decodeBC(subresource, rect);
 		break;
 	case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
 	case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:
@@ -1322,7 +1436,7 @@ void Image::decompress(const VkImageSubresource &subresource) const
 	case VK_FORMAT_ASTC_10x10_SRGB_BLOCK:
 	case VK_FORMAT_ASTC_12x10_SRGB_BLOCK:
 	case VK_FORMAT_ASTC_12x12_SRGB_BLOCK:
-		decodeASTC(subresource);
+		decodeASTC(subresource, rect);
 		break;
 	default:
 		UNSUPPORTED("Compressed format %d", (VkFormat)format);
@@ -1330,7 +1444,14 @@ void Image::decompress(const VkImageSubresource &subresource) const
 	}
 }
 
-void Image::decodeETC2(const VkImageSubresource &subresource) const
+// Compressed blocks of a rectangle are only contiguous in memory when the rectangle
+// spans the full width. Otherwise each row of blocks is decoded separately.
+static int32_t rowsPerDecode(const VkRect2D &rect, const VkExtent3D &mipLevelExtent, int blockHeight)
+{
+	return (rect.extent.width == mipLevelExtent.width) ? static_cast<int32_t>(rect.extent.height) : blockHeight;
+}
+
+void Image::decodeETC2(const VkImageSubresource &subresource, const VkRect2D &rect) const
 {
 	ASSERT(decompressedImage);
 
@@ -1338,37 +1459,39 @@ void Image::decodeETC2(const VkImageSubresource &subresource) const
 
 	int bytes = decompressedImage->format.bytes();
 	bool fakeAlpha = (format == VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK) || (format == VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK);
-	size_t sizeToWrite = 0;
 
 	VkExtent3D mipLevelExtent = getMipLevelExtent(static_cast<VkImageAspectFlagBits>(subresource.aspectMask), subresource.mipLevel);
 
 	int pitchB = decompressedImage->rowPitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, subresource.mipLevel);
-
-	if(fakeAlpha)
-	{
-		// To avoid overflow in case of cube textures, which are offset in memory to account for the border,
-		// compute the size from the first pixel to the last pixel, excluding any padding or border before
-		// the first pixel or after the last pixel.
-		sizeToWrite = ((mipLevelExtent.height - 1) * pitchB) + (mipLevelExtent.width * bytes);
-	}
+	int32_t rows = rowsPerDecode(rect, mipLevelExtent, format.blockHeight());
+	int32_t y1 = rect.offset.y + rect.extent.height;
 
 	for(int32_t depth = 0; depth < static_cast<int32_t>(mipLevelExtent.depth); depth++)
 	{
-		uint8_t *source = static_cast<uint8_t *>(getTexelPointer({ 0, 0, depth }, subresource));
-		uint8_t *dest = static_cast<uint8_t *>(decompressedImage->getTexelPointer({ 0, 0, depth }, subresource));
-
-		if(fakeAlpha)
+		for(int32_t y = rect.offset.y; y < y1; y += rows)
 		{
-			ASSERT((dest + sizeToWrite) < decompressedImage->end());
-			memset(dest, 0xFF, sizeToWrite);
-		}
+			int32_t height = std::min(rows, y1 - y);
+			uint8_t *source = static_cast<uint8_t *>(getTexelPointer({ rect.offset.x, y, depth }, subresource));
+			uint8_t *dest = static_cast<uint8_t *>(decompressedImage->getTexelPointer({ rect.offset.x, y, depth }, subresource));
 
-		ETC_Decoder::Decode(source, dest, mipLevelExtent.width, mipLevelExtent.height,
-		                    pitchB, bytes, inputType);
+			if(fakeAlpha)
+			{
+				// Only the texels within the rectangle are written, excluding any padding or
+				// border, which would overflow for the last row of cube textures.
+				for(int32_t row = 0; row < height; row++)
+				{
+					ASSERT((dest + row * pitchB + rect.extent.width * bytes) <= decompressedImage->end());
+					memset(dest + row * pitchB, 0xFF, rect.extent.width * bytes);
+				}
+			}
+
+			ETC_Decoder::Decode(source, dest, rect.extent.width, height,
+			                    pitchB, bytes, inputType);
+		}
 	}
 }
 
-void Image::decodeBC(const VkImageSubresource &subresource) const
+void Image::decodeBC(const VkImageSubresource &subresource, const VkRect2D &rect) const
 {
 	ASSERT(decompressedImage);
 
@@ -1380,18 +1503,23 @@ void Image::decodeBC(const VkImageSubresource &subresource) const
 	VkExtent3D mipLevelExtent = getMipLevelExtent(static_cast<VkImageAspectFlagBits>(subresource.aspectMask), subresource.mipLevel);
 
 	int pitchB = decompressedImage->rowPitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, subresource.mipLevel);
+	int32_t rows = rowsPerDecode(rect, mipLevelExtent, format.blockHeight());
+	int32_t y1 = rect.offset.y + rect.extent.height;
 
 	for(int32_t depth = 0; depth < static_cast<int32_t>(mipLevelExtent.depth); depth++)
 	{
-		uint8_t *source = static_cast<uint8_t *>(getTexelPointer({ 0, 0, depth }, subresource));
-		uint8_t *dest = static_cast<uint8_t *>(decompressedImage->getTexelPointer({ 0, 0, depth }, subresource));
+		for(int32_t y = rect.offset.y; y < y1; y += rows)
+		{
+			uint8_t *source = static_cast<uint8_t *>(getTexelPointer({ rect.offset.x, y, depth }, subresource));
+			uint8_t *dest = static_cast<uint8_t *>(decompressedImage->getTexelPointer({ rect.offset.x, y, depth }, subresource));
 
-		BC_Decoder::Decode(source, dest, mipLevelExtent.width, mipLevelExtent.height,
-		                   pitchB, bytes, n, noAlphaU);
+			BC_Decoder::Decode(source, dest, rect.extent.width, std::min(rows, y1 - y),
+			                   pitchB, bytes, n, noAlphaU);
+		}
 	}
 }
 
-void Image::decodeASTC(const VkImageSubresource &subresource) const
+void Image::decodeASTC(const VkImageSubresource &subresource, const VkRect2D &rect) const
 {
 	ASSERT(decompressedImage);
 
@@ -1404,25 +1532,31 @@ void Image::decodeASTC(const VkImageSubresource &subresource) const
 
 	VkExtent3D mipLevelExtent = getMipLevelExtent(static_cast<VkImageAspectFlagBits>(subresource.aspectMask), subresource.mipLevel);
 
-	int xblocks = (mipLevelExtent.width + xBlockSize - 1) / xBlockSize;
-	int yblocks = (mipLevelExtent.height + yBlockSize - 1) / yBlockSize;
+	int xblocks = (rect.extent.width + xBlockSize - 1) / xBlockSize;
 	int zblocks = (zBlockSize > 1) ? (mipLevelExtent.depth + zBlockSize - 1) / zBlockSize : 1;
 
-	if(xblocks <= 0 || yblocks <= 0 || zblocks <= 0)
+	if(xblocks <= 0 || rect.extent.height == 0 || zblocks <= 0)
 	{
 		return;
 	}
 
 	int pitchB = decompressedImage->rowPitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, subresource.mipLevel);
 	int sliceB = decompressedImage->slicePitchBytes(VK_IMAGE_ASPECT_COLOR_BIT, subresource.mipLevel);
+	int32_t rows = rowsPerDecode(rect, mipLevelExtent, yBlockSize);
+	int32_t y1 = rect.offset.y + rect.extent.height;
 
 	for(int32_t depth = 0; depth < static_cast<int32_t>(mipLevelExtent.depth); depth++)
 	{
-		uint8_t *source = static_cast<uint8_t *>(getTexelPointer({ 0, 0, depth }, subresource));
-		uint8_t *dest = static_cast<uint8_t *>(decompressedImage->getTexelPointer({ 0, 0, depth }, subresource));
+		for(int32_t y = rect.offset.y; y < y1; y += rows)
+		{
+			int32_t height = std::min(rows, y1 - y);
+			int yblocks = (height + yBlockSize - 1) / yBlockSize;
+			uint8_t *source = static_cast<uint8_t *>(getTexelPointer({ rect.offset.x, y, depth }, subresource));
+			uint8_t *dest = static_cast<uint8_t *>(decompressedImage->getTexelPointer({ rect.offset.x, y, depth }, subresource));
 
-		ASTC_Decoder::Decode(source, dest, mipLevelExtent.width, mipLevelExtent.height, mipLevelExtent.depth, bytes, pitchB, sliceB,
-		                     xBlockSize, yBlockSize, zBlockSize, xblocks, yblocks, zblocks, isUnsigned);
+			ASTC_Decoder::Decode(source, dest, rect.extent.width, height, mipLevelExtent.depth, bytes, pitchB, sliceB,
+			                     xBlockSize, yBlockSize, zBlockSize, xblocks, yblocks, zblocks, isUnsigned);
+		}
 	}
 }
 
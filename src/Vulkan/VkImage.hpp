@@ -24,7 +24,7 @@
 #	include <vulkan/vk_android_native_buffer.h>  // For VkSwapchainImageUsageFlagsANDROID and buffer_handle_t
 #endif
 
-#include <unordered_set>
+#include <unordered_map>
 
 namespace vk {
 
@@ -87,6 +87,7 @@ public:
 	uint32_t getArrayLayers() const { return arrayLayers; }
 	uint32_t getMipLevels() const { return mipLevels; }
 	VkImageUsageFlags getUsage() const { return usage; }
+	VkImageUsageFlags getStencilUsage() const { return stencilUsage; }
 	VkImageCreateFlags getFlags() const { return flags; }
 	VkSampleCountFlagBits getSampleCount() const { return samples; }
 	const VkExtent3D &getExtent() const { return extent; }
@@ -107,7 +108,9 @@ public:
 		DIRECT_MEMORY_ACCESS = 0,
 		USING_STORAGE = 1
 	};
-	void contentsChanged(const VkImageSubresourceRange &subresourceRange, ContentsChangedContext contentsChangedContext = DIRECT_MEMORY_ACCESS);
+	// For single mip level ranges, a dirty rectangle narrows down the changed texels, so
+	// that preprocessing for sampling only has to redo that part.
+	void contentsChanged(const VkImageSubresourceRange &subresourceRange, ContentsChangedContext contentsChangedContext = DIRECT_MEMORY_ACCESS, const VkRect2D *dirtyRect = nullptr);
 	const Image *getSampledImage(const vk::Format &imageViewFormat) const;
 
 #ifdef __ANDROID__
@@ -131,6 +134,7 @@ private:
 		const VkOffset3D                  &imageCopyOffset,
 		const VkExtent3D                  &imageCopyExtent);
 	void copySingleAspectTo(Image *dstImage, const VkImageCopy2KHR &region) const;
+	bool isWholeImageCopy(const Image *dstImage, const VkImageCopy2KHR &region) const;
 	VkDeviceSize getStorageSize(VkImageAspectFlags flags) const;
 	VkDeviceSize getMultiSampledLevelSize(VkImageAspectFlagBits aspect, uint32_t mipLevel) const;
 	VkDeviceSize getLayerOffset(VkImageAspectFlagBits aspect, uint32_t mipLevel) const;
@@ -145,10 +149,11 @@ private:
 	int borderSize() const;
 
 	bool requiresPreprocessing() const;
-	void decompress(const VkImageSubresource &subresource) const;
-	void decodeETC2(const VkImageSubresource &subresource) const;
-	void decodeBC(const VkImageSubresource &subresource) const;
-	void decodeASTC(const VkImageSubresource &subresource) const;
+	VkRect2D getDirtyRect(const VkImageSubresource &subresource, const VkRect2D *dirtyRect) const;
+	void decompress(const VkImageSubresource &subresource, const VkRect2D &rect) const;
+	void decodeETC2(const VkImageSubresource &subresource, const VkRect2D &rect) const;
+	void decodeBC(const VkImageSubresource &subresource, const VkRect2D &rect) const;
+	void decodeASTC(const VkImageSubresource &subresource, const VkRect2D &rect) const;
 
 	const Device *const device = nullptr;
 	VkDeviceSize memoryOffset = 0;
@@ -161,6 +166,7 @@ private:
 	VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
 	VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL;
 	VkImageUsageFlags usage = (VkImageUsageFlags)0;
+	VkImageUsageFlags stencilUsage = (VkImageUsageFlags)0;
 	Image *decompressedImage = nullptr;
 #ifdef __ANDROID__
 	BackingMemory backingMemory = {};
@@ -168,7 +174,7 @@ private:
 
 	VkExternalMemoryHandleTypeFlags supportedExternalMemoryHandleTypes = (VkExternalMemoryHandleTypeFlags)0;
 
-	// VkImageSubresource wrapper for use in unordered_set
+	// VkImageSubresource wrapper for use in unordered_map
 	class Subresource
 	{
 	public:
@@ -199,7 +205,7 @@ private:
 	};
 
 	mutable marl::mutex mutex;
-	mutable std::unordered_set<Subresource, Subresource> dirtySubresources GUARDED_BY(mutex);
+	mutable std::unordered_map<Subresource, VkRect2D, Subresource> dirtySubresources GUARDED_BY(mutex);  // Bounds of the changed texels
 };
 
 static inline Image *Cast(VkImage object)
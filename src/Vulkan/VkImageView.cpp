@@ -14,6 +14,7 @@
 
 #include "VkImageView.hpp"
 
+#include "VkDescriptorSetLayout.hpp"
 #include "VkImage.hpp"
 #include "VkStructConversion.hpp"
 #include "System/Math.hpp"
@@ -135,15 +136,26 @@ ImageView::ImageView(const VkImageViewCreateInfo *pCreateInfo, void *mem, const
     , ycbcrConversion(ycbcrConversion)
     , id(pCreateInfo)
 {
+	if(mem)
+	{
+		sampledImageDescriptor = reinterpret_cast<SampledImageDescriptor *>(mem);
+		DescriptorSetLayout::WriteSampledImageDescriptor(sampledImageDescriptor, this);
+	}
 }
 
 size_t ImageView::ComputeRequiredAllocationSize(const VkImageViewCreateInfo *pCreateInfo)
 {
-	return 0;
+	// Only views of sampled images need their descriptor contents. The stencil
+	// aspect can be sampled through VkImageStencilUsageCreateInfo alone.
+	const Image *image = vk::Cast(pCreateInfo->image);
+	bool sampled = ((image->getUsage() | image->getStencilUsage()) & VK_IMAGE_USAGE_SAMPLED_BIT) != 0;
+
+	return sampled ? sizeof(SampledImageDescriptor) : 0;
 }
 
 void ImageView::destroy(const VkAllocationCallbacks *pAllocator)
 {
+	vk::freeHostMemory(sampledImageDescriptor, pAllocator);
 }
 
 // Vulkan 1.2 Table 8. Image and image view parameter compatibility requirements
@@ -26,6 +26,7 @@
 namespace vk {
 
 class SamplerYcbcrConversion;
+struct SampledImageDescriptor;
 
 // Uniquely identifies state used by sampling routine generation.
 // Integer ID space shared by image views and buffer views.
@@ -137,6 +138,13 @@ public:
 	const VkImageSubresourceRange &getSubresourceRange() const { return subresourceRange; }
 	size_t getSizeInBytes() const { return image->getSizeInBytes(subresourceRange); }
 
+	// Sampled image descriptor contents for the view, built at creation.
+	const SampledImageDescriptor *getSampledImageDescriptor() const
+	{
+		ASSERT(sampledImageDescriptor);
+		return sampledImageDescriptor;
+	}
+
 private:
 	bool imageTypesMatch(VkImageType imageType) const;
 	const Image *getImage(Usage usage) const;
@@ -154,6 +162,7 @@ private:
 	const VkImageSubresourceRange subresourceRange = {};
 
 	const vk::SamplerYcbcrConversion *ycbcrConversion = nullptr;
+	SampledImageDescriptor *sampledImageDescriptor = nullptr;
 
 public:
 	const Identifier id;
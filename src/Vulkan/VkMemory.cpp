@@ -16,8 +16,46 @@
 
 #include "VkConfig.hpp"
 #include "System/Debug.hpp"
+#include "System/Math.hpp"
 #include "System/Memory.hpp"
 
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Object storage is handed out in size classes, and freed storage is kept on a free list
+// of its class, so that transient objects don't need a round trip through malloc().
+constexpr size_t ObjectSizeClassGranularity = 64;
+constexpr size_t ObjectSizeClassCount = 16;  // Objects of up to 1 KiB
+constexpr size_t MaxFreeObjectsPerSizeClass = 64;
+constexpr uint32_t UnpooledObject = ~0u;
+
+// Precedes the storage of each object. Its size keeps objects aligned for vector types.
+struct ObjectHeader
+{
+	uint32_t sizeClass;
+	void *block;
+};
+
+constexpr size_t ObjectHeaderSize = vk::HOST_MEMORY_ALLOCATION_ALIGNMENT;
+static_assert(sizeof(ObjectHeader) <= ObjectHeaderSize, "Object header must not overlap the object");
+
+struct ObjectFreeList
+{
+	std::mutex mutex;
+	std::vector<void *> blocks;
+};
+
+ObjectFreeList *getObjectFreeLists()
+{
+	// Never destroyed, since objects may outlive static destructors.
+	static ObjectFreeList *freeLists = new ObjectFreeList[ObjectSizeClassCount];
+	return freeLists;
+}
+
+}  // anonymous namespace
+
 namespace vk {
 
 void *allocateDeviceMemory(size_t bytes, size_t alignment)
@@ -63,4 +101,88 @@ void freeHostMemory(void *ptr, const VkAllocationCallbacks *pAllocator)
 	}
 }
 
+void *allocateObjectMemory(size_t bytes, size_t alignment, const VkAllocationCallbacks *pAllocator, VkSystemAllocationScope allocationScope)
+{
+	ASSERT(bytes <= vk::MAX_MEMORY_ALLOCATION_SIZE);
+
+	if(pAllocator)
+	{
+		return pAllocator->pfnAllocation(pAllocator->pUserData, bytes, alignment, allocationScope);
+	}
+
+	// Zero-initialization is left out, which MemorySanitizer builds already rely on.
+	size_t sizeClass = (bytes - 1) / ObjectSizeClassGranularity;
+	if((sizeClass >= ObjectSizeClassCount) || (alignment > ObjectHeaderSize))
+	{
+		size_t offset = sw::align(ObjectHeaderSize, static_cast<unsigned int>(alignment));
+		uint8_t *block = static_cast<uint8_t *>(sw::allocate(offset + bytes, alignment));
+		if(!block)
+		{
+			return nullptr;
+		}
+
+		ObjectHeader *header = reinterpret_cast<ObjectHeader *>(block + offset - ObjectHeaderSize);
+		header->sizeClass = UnpooledObject;
+		header->block = block;
+
+		return block + offset;
+	}
+
+	uint8_t *block = nullptr;
+	{
+		ObjectFreeList &freeList = getObjectFreeLists()[sizeClass];
+		std::lock_guard<std::mutex> lock(freeList.mutex);
+		if(!freeList.blocks.empty())
+		{
+			block = static_cast<uint8_t *>(freeList.blocks.back());
+			freeList.blocks.pop_back();
+		}
+	}
+
+	if(!block)
+	{
+		block = static_cast<uint8_t *>(sw::allocate(ObjectHeaderSize + (sizeClass + 1) * ObjectSizeClassGranularity, ObjectHeaderSize));
+		if(!block)
+		{
+			return nullptr;
+		}
+	}
+
+	ObjectHeader *header = reinterpret_cast<ObjectHeader *>(block);
+	header->sizeClass = static_cast<uint32_t>(sizeClass);
+	header->block = block;
+
+	return block + ObjectHeaderSize;
+}
+
+void freeObjectMemory(void *ptr, const VkAllocationCallbacks *pAllocator)
+{
+	if(pAllocator)
+	{
+		pAllocator->pfnFree(pAllocator->pUserData, ptr);
+		return;
+	}
+
+	if(!ptr)
+	{
+		return;
+	}
+
+	const ObjectHeader *header = reinterpret_cast<const ObjectHeader *>(static_cast<uint8_t *>(ptr) - ObjectHeaderSize);
+	void *block = header->block;
+
+	if(header->sizeClass != UnpooledObject)
+	{
+		ObjectFreeList &freeList = getObjectFreeLists()[header->sizeClass];
+		std::lock_guard<std::mutex> lock(freeList.mutex);
+		if(freeList.blocks.size() < MaxFreeObjectsPerSizeClass)
+		{
+			freeList.blocks.push_back(block);
+			return;
+		}
+	}
+
+	sw::freeMemory(block);
+}
+
 }  // namespace vk
@@ -32,6 +32,12 @@ void *allocateHostMemory(size_t bytes, size_t alignment, const VkAllocationCallb
                          VkSystemAllocationScope allocationScope);
 void freeHostMemory(void *ptr, const VkAllocationCallbacks *pAllocator);
 
+// Storage for Vulkan objects, which their constructor fully initializes. Without allocation
+// callbacks it isn't zero-initialized, and gets recycled for objects of similar size.
+void *allocateObjectMemory(size_t bytes, size_t alignment, const VkAllocationCallbacks *pAllocator,
+                           VkSystemAllocationScope allocationScope);
+void freeObjectMemory(void *ptr, const VkAllocationCallbacks *pAllocator);
+
 template<typename T>
 T *allocateHostmemory(size_t bytes, const VkAllocationCallbacks *pAllocator)
 {
@@ -55,7 +55,7 @@ static VkResult Create(const VkAllocationCallbacks *pAllocator, const CreateInfo
 		}
 	}
 
-	void *objectMemory = vk::allocateHostMemory(sizeof(T), alignof(T), pAllocator, T::GetAllocationScope());
+	void *objectMemory = vk::allocateObjectMemory(sizeof(T), alignof(T), pAllocator, T::GetAllocationScope());
 	if(!objectMemory)
 	{
 		vk::freeHostMemory(memory, pAllocator);
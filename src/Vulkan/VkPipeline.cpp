@@ -471,6 +471,29 @@ bool GraphicsPipeline::fragmentContainsImageWrite() const
 	return fragmentShader.get() && fragmentShader->containsImageWrite();
 }
 
+std::shared_ptr<sw::ResolvedRoutines> GraphicsPipeline::getResolvedRoutines(uint64_t signatureHash) const
+{
+	marl::lock lock(resolvedRoutinesMutex);
+
+	auto it = resolvedRoutines.find(signatureHash);
+	return (it != resolvedRoutines.end()) ? it->second : nullptr;
+}
+
+void GraphicsPipeline::setResolvedRoutines(uint64_t signatureHash, const std::shared_ptr<sw::ResolvedRoutines> &routines) const
+{
+	marl::lock lock(resolvedRoutinesMutex);
+
+	// Pipelines are typically drawn with only a handful of distinct dynamic states.
+	// Start over rather than growing without bound when that doesn't hold.
+	constexpr size_t maxResolvedRoutines = 16;
+	if(resolvedRoutines.size() >= maxResolvedRoutines)
+	{
+		resolvedRoutines.clear();
+	}
+
+	resolvedRoutines[signatureHash] = routines;
+}
+
 void GraphicsPipeline::setShader(const VkShaderStageFlagBits &stage, const std::shared_ptr<sw::SpirvShader> spirvShader)
 {
 	switch(stage)
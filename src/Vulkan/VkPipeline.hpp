@@ -18,11 +18,13 @@
 #include "Device/Context.hpp"
 #include "Vulkan/VkPipelineCache.hpp"
 #include <memory>
+#include <unordered_map>
 
 namespace sw {
 
 class ComputeProgram;
 class SpirvShader;
+struct ResolvedRoutines;
 
 }  // namespace sw
 
@@ -109,6 +111,10 @@ public:
 
 	const std::shared_ptr<sw::SpirvShader> getShader(const VkShaderStageFlagBits &stage) const;
 
+	// Routines resolved by the renderer, memoized per dynamic state signature hash.
+	std::shared_ptr<sw::ResolvedRoutines> getResolvedRoutines(uint64_t signatureHash) const;
+	void setResolvedRoutines(uint64_t signatureHash, const std::shared_ptr<sw::ResolvedRoutines> &routines) const;
+
 private:
 	void setShader(const VkShaderStageFlagBits &stage, const std::shared_ptr<sw::SpirvShader> spirvShader);
 	std::shared_ptr<sw::SpirvShader> vertexShader;
@@ -119,6 +125,9 @@ private:
 	IndexBuffer indexBuffer;
 	Attachments attachments;
 	Inputs inputs;
+
+	mutable marl::mutex resolvedRoutinesMutex;
+	mutable std::unordered_map<uint64_t, std::shared_ptr<sw::ResolvedRoutines>> resolvedRoutines GUARDED_BY(resolvedRoutinesMutex);
 };
 
 class ComputePipeline : public Pipeline, public ObjectBase<ComputePipeline, VkPipeline>
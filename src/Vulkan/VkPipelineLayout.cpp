@@ -104,6 +104,17 @@ uint32_t PipelineLayout::getBindingCount(uint32_t setNumber) const
 	return descriptorSets[setNumber].bindingCount;
 }
 
+uint32_t PipelineLayout::getPushConstantRangeCount() const
+{
+	return pushConstantRangeCount;
+}
+
+const VkPushConstantRange &PipelineLayout::getPushConstantRange(uint32_t index) const
+{
+	ASSERT(index < pushConstantRangeCount);
+	return pushConstantRanges[index];
+}
+
 uint32_t PipelineLayout::getDynamicOffsetIndex(uint32_t setNumber, uint32_t bindingNumber) const
 {
 	ASSERT(setNumber < descriptorSetCount && bindingNumber < descriptorSets[setNumber].bindingCount);
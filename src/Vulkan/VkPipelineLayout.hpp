@@ -41,6 +41,9 @@ public:
 	uint32_t getDescriptorSize(uint32_t setNumber, uint32_t bindingNumber) const;
 	bool isDescriptorDynamic(uint32_t setNumber, uint32_t bindingNumber) const;
 
+	uint32_t getPushConstantRangeCount() const;
+	const VkPushConstantRange &getPushConstantRange(uint32_t index) const;
+
 	const uint32_t identifier;
 
 	uint32_t incRefCount();
@@ -25,6 +25,7 @@ Query::Query(VkQueryType type)
     , state(UNAVAILABLE)
     , type(type)
     , value(0)
+    , precise(true)
 {}
 
 void Query::reset()
@@ -80,6 +81,16 @@ void Query::add(int64_t v)
 	value += v;
 }
 
+void Query::setPrecise(bool p)
+{
+	precise = p;
+}
+
+bool Query::isPrecise() const
+{
+	return precise;
+}
+
 QueryPool::QueryPool(const VkQueryPoolCreateInfo *pCreateInfo, void *mem)
     : pool(reinterpret_cast<Query *>(mem))
     , type(pCreateInfo->queryType)
@@ -191,6 +202,7 @@ void QueryPool::begin(uint32_t query, VkQueryControlFlags flags)
 		UNSUPPORTED("vkCmdBeginQuery::flags 0x%08X", int(flags));
 	}
 
+	pool[query].setPrecise((flags & VK_QUERY_CONTROL_PRECISE_BIT) != 0);
 	pool[query].start();
 }
 
@@ -75,12 +75,21 @@ public:
 	// add() adds val to the current query value.
 	void add(int64_t val);
 
+	// setPrecise() records whether the query was begun with
+	// VK_QUERY_CONTROL_PRECISE_BIT. Imprecise occlusion queries only need to
+	// report a nonzero value when any sample passed.
+	void setPrecise(bool precise);
+
+	// isPrecise() returns true if exact sample counts are required.
+	bool isPrecise() const;
+
 private:
 	marl::WaitGroup wg;
 	marl::Event finished;
 	std::atomic<State> state;
 	std::atomic<VkQueryType> type;
 	std::atomic<int64_t> value;
+	std::atomic<bool> precise;
 };
 
 class QueryPool : public Object<QueryPool, VkQueryPool>
@@ -99,6 +99,10 @@ void Queue::submitQueue(const Task &task)
 			CommandBuffer::ExecutionState executionState;
 			executionState.renderer = renderer.get();
 			executionState.events = task.events.get();
+
+			// Host writes become visible to a new submission.
+			renderer->invalidateVertexResults();
+
 			for(uint32_t j = 0; j < submitInfo.commandBufferCount; j++)
 			{
 				Cast(submitInfo.pCommandBuffers[j])->submit(executionState);
@@ -157,4 +157,56 @@ BENCHMARK_CAPTURE(Transcendental1, rr_Log2, LIFT(rr::Log2))->Arg(REPS);
 BENCHMARK_CAPTURE(Transcendental1, sw_Log2_highp, LIFT(sw::Log2), false /* relaxedPrecision */)->Arg(REPS);
 BENCHMARK_CAPTURE(Transcendental1, sw_Log2_mediump, LIFT(sw::Log2), true /* relaxedPrecision */)->Arg(REPS);
 
+// Builds a loop shaped like a fragment shader's arithmetic: a uniform value is
+// re-loaded every iteration and combined with per-element transcendentals.
+using ShaderLoop = FunctionT<void(float *, float *, int)>;
+
+static void buildShaderLoop(ShaderLoop &function)
+{
+	Pointer<SIMD::Float> r = Pointer<Float>(function.Arg<0>());
+	Pointer<SIMD::Float> a = Pointer<Float>(function.Arg<1>());
+	Int count = function.Arg<2>();
+
+	For(Int i = 0, i < count, i++)
+	{
+		SIMD::Float x = a[i];
+		r[i] = sw::Sin(x, false) * sw::Exp(x, false) + sw::Pow<Highp>(x, a[0]);
+	}
+}
+
+// The pass argument is an rr::OptimizationPass flag added to the default
+// pipeline, or 0 for the default pipeline alone.
+static void OptimizationPass_Compile(benchmark::State &state)
+{
+	rr::ScopedPragma optimizationPasses(rr::OptimizationPasses, static_cast<int>(state.range(0)));
+
+	for(auto _ : state)
+	{
+		ShaderLoop function;
+		buildShaderLoop(function);
+		auto routine = function("shaderLoop");
+		benchmark::DoNotOptimize(routine);
+	}
+}
+
+static void OptimizationPass_Run(benchmark::State &state)
+{
+	rr::ScopedPragma optimizationPasses(rr::OptimizationPasses, static_cast<int>(state.range(0)));
+
+	ShaderLoop function;
+	buildShaderLoop(function);
+	auto routine = function("shaderLoop");
+
+	std::vector<float> r(REPS * SIMD::Width);
+	std::vector<float> a(REPS * SIMD::Width, 0.456f);
+
+	for(auto _ : state)
+	{
+		routine(r.data(), a.data(), REPS);
+	}
+}
+
+BENCHMARK(OptimizationPass_Compile)->Arg(0)->RangeMultiplier(2)->Range(rr::EarlyCSE, rr::AggressiveDCE)->ArgName("pass");
+BENCHMARK(OptimizationPass_Run)->Arg(0)->RangeMultiplier(2)->Range(rr::EarlyCSE, rr::AggressiveDCE)->ArgName("pass");
+
 }  // namespace sw
\ No newline at end of file
@@ -140,3 +140,88 @@ BENCHMARK_CAPTURE(Transcedental1, rr_Exp, Exp);
 BENCHMARK_CAPTURE(Transcedental1, rr_Log, Log);
 BENCHMARK_CAPTURE(Transcedental1, rr_Exp2, LIFT(Exp2));
 BENCHMARK_CAPTURE(Transcedental1, rr_Log2, LIFT(Log2));
+
+// Builds a routine shaped like a typical shader loop: every iteration
+// re-loads fields from a descriptor-like structure and recomputes addresses
+// which are invariant across the loop, leaving the optimizer to hoist them.
+using DescriptorLoop = FunctionT<float(const float *, const int *, int)>;
+
+static void buildDescriptorLoop(DescriptorLoop &function)
+{
+	Pointer<Byte> data = function.Arg<0>();
+	Pointer<Byte> descriptor = function.Arg<1>();
+	Int count = function.Arg<2>();
+
+	Float4 sum = Float4(0.0f);
+	For(Int i = 0, i < count, i++)
+	{
+		Int offset = *Pointer<Int>(descriptor);
+		Int stride = *Pointer<Int>(descriptor + sizeof(int));
+		Int index = offset + (i & 15) * stride;
+		Float4 v = *Pointer<Float4>(data + index * sizeof(float));
+		sum += v * Float4(*Pointer<Float>(data + offset * sizeof(float))) + Sqrt(Abs(v));
+	}
+
+	Return(Float(sum.x) + Float(sum.y) + Float(sum.z) + Float(sum.w));
+}
+
+static void DescriptorLoop_Compile(benchmark::State &state)
+{
+	for(auto _ : state)
+	{
+		DescriptorLoop function;
+		buildDescriptorLoop(function);
+		auto routine = function("descriptorLoop");
+		benchmark::DoNotOptimize(routine);
+	}
+}
+
+static void DescriptorLoop_Run(benchmark::State &state)
+{
+	DescriptorLoop function;
+	buildDescriptorLoop(function);
+	auto routine = function("descriptorLoop");
+
+	alignas(16) float data[128] = {};
+	int descriptor[2] = { 4, 4 };
+	for(int i = 0; i < 128; i++)
+	{
+		data[i] = static_cast<float>(i);
+	}
+
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(routine(data, descriptor, 1024));
+	}
+}
+
+static void OptimizationLevel_Compile(benchmark::State &state)
+{
+	ScopedPragma optimizationLevel(OptimizationLevel, static_cast<int>(state.range(0)));
+	DescriptorLoop_Compile(state);
+}
+
+static void OptimizationLevel_Run(benchmark::State &state)
+{
+	ScopedPragma optimizationLevel(OptimizationLevel, static_cast<int>(state.range(0)));
+	DescriptorLoop_Run(state);
+}
+
+// The pass argument is an OptimizationPass flag added to the default pipeline,
+// or 0 for the default pipeline alone.
+static void OptimizationPass_Compile(benchmark::State &state)
+{
+	ScopedPragma optimizationPasses(OptimizationPasses, static_cast<int>(state.range(0)));
+	DescriptorLoop_Compile(state);
+}
+
+static void OptimizationPass_Run(benchmark::State &state)
+{
+	ScopedPragma optimizationPasses(OptimizationPasses, static_cast<int>(state.range(0)));
+	DescriptorLoop_Run(state);
+}
+
+BENCHMARK(OptimizationLevel_Compile)->DenseRange(0, 3)->ArgName("level");
+BENCHMARK(OptimizationLevel_Run)->DenseRange(0, 3)->ArgName("level");
+BENCHMARK(OptimizationPass_Compile)->Arg(0)->RangeMultiplier(2)->Range(EarlyCSE, AggressiveDCE)->ArgName("pass");
+BENCHMARK(OptimizationPass_Run)->Arg(0)->RangeMultiplier(2)->Range(EarlyCSE, AggressiveDCE)->ArgName("pass");
@@ -407,8 +407,31 @@ TEST(ReactorUnitTests, ConstantPointer)
 	EXPECT_EQ(result, 44);
 }
 
+TEST(ReactorUnitTests, Prefetch)
+{
+	int c[2] = { 44, 55 };
+
+	FunctionT<int(int *)> function;
+	{
+		Pointer<Int> p = function.Arg<0>();
+
+		// Prefetching must not fault, even for addresses which aren't dereferenceable.
+		Prefetch(Pointer<Byte>(p));
+		Prefetch(Pointer<Byte>(p) + 0x7FFFFFF0);
+
+		Int x = p[1];
+		Return(x);
+	}
+
+	auto routine = function(testName().c_str());
+
+	int result = routine(c);
+	EXPECT_EQ(result, 55);
+}
+
 // This test excercises the Optimizer::eliminateLoadsFollowingSingleStore() optimization pass.
-// The three load operations for `y` should get eliminated.
+// The three load operations for `y` should get eliminated, together with its store and alloca.
+// The store to `z` doesn't dominate its load, so `z` must remain in memory.
 TEST(ReactorUnitTests, EliminateLoadsFollowingSingleStore)
 {
 	FunctionT<int(int)> function;
@@ -429,9 +452,9 @@ TEST(ReactorUnitTests, EliminateLoadsFollowingSingleStore)
 	}
 
 	Nucleus::setOptimizerCallback([](const Nucleus::OptimizerReport *report) {
-		EXPECT_EQ(report->allocas, 2);
-		EXPECT_EQ(report->loads, 2);
-		EXPECT_EQ(report->stores, 2);
+		EXPECT_EQ(report->allocas, 1);
+		EXPECT_EQ(report->loads, 1);
+		EXPECT_EQ(report->stores, 1);
 	});
 
 	auto routine = function(testName().c_str());
@@ -441,7 +464,8 @@ TEST(ReactorUnitTests, EliminateLoadsFollowingSingleStore)
 }
 
 // This test excercises the Optimizer::propagateAlloca() optimization pass.
-// The pointer variable should not get stored to / loaded from memory.
+// The pointer variable should not get stored to / loaded from memory. This
+// leaves `a` with a single store which dominates its load, so it gets eliminated too.
 TEST(ReactorUnitTests, PropagateAlloca)
 {
 	FunctionT<int(int)> function;
@@ -462,9 +486,9 @@ TEST(ReactorUnitTests, PropagateAlloca)
 	}
 
 	Nucleus::setOptimizerCallback([](const Nucleus::OptimizerReport *report) {
-		EXPECT_EQ(report->allocas, 1);
-		EXPECT_EQ(report->loads, 1);
-		EXPECT_EQ(report->stores, 1);
+		EXPECT_EQ(report->allocas, 0);
+		EXPECT_EQ(report->loads, 0);
+		EXPECT_EQ(report->stores, 0);
 	});
 
 	auto routine = function(testName().c_str());
@@ -521,6 +545,84 @@ TEST(ReactorUnitTests, ArrayOfPointersToLocals)
 	EXPECT_EQ(result, 222);
 }
 
+// This test excercises the Optimizer::foldConstants() optimization pass.
+// Division by zero must not be folded, so the branch guarding it must remain effective.
+TEST(ReactorUnitTests, FoldConstants)
+{
+	FunctionT<int(int)> function;
+	{
+		Int x = function.Arg<0>();
+
+		Int a = 6;
+		Int b = 7;
+		Int zero = 0;
+		Int result = (a * b - (a << 2)) + (x & -1) + (x * 0) + (x - 0);
+
+		If(x == 0)
+		{
+			result = result / zero;
+		}
+
+		Return(result);
+	}
+
+	Nucleus::setOptimizerCallback([](const Nucleus::OptimizerReport *report) {
+		EXPECT_GT(report->foldedConstants, 0);
+	});
+
+	auto routine = function(testName().c_str());
+
+	int result = routine(5);
+	EXPECT_EQ(result, 28);
+}
+
+// This test excercises the Optimizer::eliminateCommonSubexpressions() and
+// Optimizer::hoistLoopInvariants() optimization passes.
+TEST(ReactorUnitTests, LoopInvariantCommonSubexpressions)
+{
+	FunctionT<int(int, int, int)> function;
+	{
+		Int x = function.Arg<0>();
+		Int y = function.Arg<1>();
+		Int n = function.Arg<2>();
+
+		Int sum = x * y + 1;
+
+		For(Int i = 0, i < n, i++)
+		{
+			sum += (x * y + 1) + ((x - y) << 2) * i;
+
+			If(i > 2)
+			{
+				sum -= (y * x + 1) + ((x - y) << 2);
+			}
+		}
+
+		Return(sum);
+	}
+
+	Nucleus::setOptimizerCallback([](const Nucleus::OptimizerReport *report) {
+		EXPECT_GT(report->eliminatedSubexpressions, 0);
+		EXPECT_GT(report->hoistedInvariants, 0);
+	});
+
+	auto routine = function(testName().c_str());
+
+	int expected = 3 * 4 + 1;
+	for(int i = 0; i < 6; i++)
+	{
+		expected += (3 * 4 + 1) + ((3 - 4) << 2) * i;
+
+		if(i > 2)
+		{
+			expected -= (4 * 3 + 1) + ((3 - 4) << 2);
+		}
+	}
+
+	EXPECT_EQ(routine(3, 4, 6), expected);
+	EXPECT_EQ(routine(3, 4, 0), 13);
+}
+
 TEST(ReactorUnitTests, ModifyLocalThroughPointer)
 {
 	FunctionT<int(void)> function;
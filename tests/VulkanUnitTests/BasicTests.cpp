@@ -182,3 +182,112 @@ TEST_F(BasicTest, UnsupportedDeviceExtension_DISABLED)
     driver.vkDestroyInstance(instance, nullptr);
 }
 */
+
+// Large copies may share pages between the source and the destination.
+// Writes to either side must not be visible through the other.
+TEST_F(BasicTest, CopyBufferWritesStayIndependent)
+{
+	const VkInstanceCreateInfo createInfo = {
+		VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,  // sType
+		nullptr,                                 // pNext
+		0,                                       // flags
+		nullptr,                                 // pApplicationInfo
+		0,                                       // enabledLayerCount
+		nullptr,                                 // ppEnabledLayerNames
+		0,                                       // enabledExtensionCount
+		nullptr,                                 // ppEnabledExtensionNames
+	};
+	VkInstance instance = VK_NULL_HANDLE;
+	ASSERT_EQ(driver.vkCreateInstance(&createInfo, nullptr, &instance), VK_SUCCESS);
+
+	ASSERT_TRUE(driver.resolve(instance));
+
+	std::unique_ptr<Device> device;
+	ASSERT_EQ(Device::CreateComputeDevice(&driver, instance, device), VK_SUCCESS);
+	ASSERT_TRUE(device->IsValid());
+
+	// Larger than the minimum size for sharing pages, with partial pages at both ends.
+	constexpr VkDeviceSize memorySize = 4 * 1024 * 1024;
+	constexpr VkDeviceSize copyOffset = 256;
+	constexpr VkDeviceSize copySize = memorySize - 2 * copyOffset;
+	constexpr size_t count = copySize / sizeof(uint32_t);
+
+	VkDeviceMemory srcMemory;
+	VkDeviceMemory dstMemory;
+	const VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	ASSERT_EQ(device->AllocateMemory(memorySize, flags, &srcMemory), VK_SUCCESS);
+	ASSERT_EQ(device->AllocateMemory(memorySize, flags, &dstMemory), VK_SUCCESS);
+
+	VkBuffer srcBuffer;
+	VkBuffer dstBuffer;
+	ASSERT_EQ(device->CreateBuffer(srcMemory, copySize, copyOffset, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, &srcBuffer), VK_SUCCESS);
+	ASSERT_EQ(device->CreateBuffer(dstMemory, copySize, copyOffset, VK_BUFFER_USAGE_TRANSFER_DST_BIT, &dstBuffer), VK_SUCCESS);
+
+	uint32_t *src;
+	uint32_t *dst;
+	ASSERT_EQ(device->MapMemory(srcMemory, copyOffset, copySize, 0, (void **)&src), VK_SUCCESS);
+	for(size_t i = 0; i < count; i++)
+	{
+		src[i] = static_cast<uint32_t>(i);
+	}
+	device->UnmapMemory(srcMemory);
+
+	VkCommandPool commandPool;
+	ASSERT_EQ(device->CreateCommandPool(&commandPool), VK_SUCCESS);
+
+	VkCommandBuffer commandBuffer;
+	ASSERT_EQ(device->AllocateCommandBuffer(commandPool, &commandBuffer), VK_SUCCESS);
+	ASSERT_EQ(device->BeginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, commandBuffer), VK_SUCCESS);
+
+	const VkBufferCopy region = {
+		0,         // srcOffset
+		0,         // dstOffset
+		copySize,  // size
+	};
+	driver.vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &region);
+
+	ASSERT_EQ(driver.vkEndCommandBuffer(commandBuffer), VK_SUCCESS);
+	ASSERT_EQ(device->QueueSubmitAndWait(commandBuffer), VK_SUCCESS);
+
+	ASSERT_EQ(device->MapMemory(srcMemory, copyOffset, copySize, 0, (void **)&src), VK_SUCCESS);
+	ASSERT_EQ(device->MapMemory(dstMemory, copyOffset, copySize, 0, (void **)&dst), VK_SUCCESS);
+
+	for(size_t i = 0; i < count; i++)
+	{
+		ASSERT_EQ(dst[i], static_cast<uint32_t>(i)) << "Unexpected copy at " << i;
+	}
+
+	// Write the source. The destination keeps the copied values.
+	for(size_t i = 0; i < count; i++)
+	{
+		src[i] = static_cast<uint32_t>(i) ^ 0xFFFFFFFF;
+	}
+
+	for(size_t i = 0; i < count; i++)
+	{
+		ASSERT_EQ(dst[i], static_cast<uint32_t>(i)) << "Source write visible in destination at " << i;
+	}
+
+	// Write the destination. The source keeps its new values.
+	for(size_t i = 0; i < count; i++)
+	{
+		dst[i] = static_cast<uint32_t>(i) * 3;
+	}
+
+	for(size_t i = 0; i < count; i++)
+	{
+		ASSERT_EQ(src[i], static_cast<uint32_t>(i) ^ 0xFFFFFFFF) << "Destination write visible in source at " << i;
+	}
+
+	device->UnmapMemory(srcMemory);
+	device->UnmapMemory(dstMemory);
+
+	device->FreeCommandBuffer(commandPool, commandBuffer);
+	device->DestroyCommandPool(commandPool);
+	device->DestroyBuffer(srcBuffer);
+	device->DestroyBuffer(dstBuffer);
+	device->FreeMemory(srcMemory);
+	device->FreeMemory(dstMemory);
+	device.reset(nullptr);
+	driver.vkDestroyInstance(instance, nullptr);
+}
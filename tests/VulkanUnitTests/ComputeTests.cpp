@@ -1481,3 +1481,676 @@ TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, LoopDivergentMergePhi)
 	test(
 	    src.str(), [](uint32_t i) { return i; }, [](uint32_t i) { return i; });
 }
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, FunctionCallDivergentReturn)
+{
+	// #version 450
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     int Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     int Data[];
+	// } Out;
+	// [[dont_inline]] int f(int x)
+	// {
+	//     if (x % 2 == 0)
+	//     {
+	//         return x * 2;
+	//     }
+	//     return x + 1;
+	// }
+	// void main()
+	// {
+	//     int in = In.Data[gl_GlobalInvocationID.x];
+	//     Out.Data[gl_GlobalInvocationID.x] = f(in) + f(1);
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"              // void()
+        "%9 = OpTypeInt 32 1\n"                 // int32
+        "%10 = OpTypeInt 32 0\n"                // uint32
+        "%11 = OpTypeBool\n"
+        "%3 = OpTypeRuntimeArray %9\n"          // int32[]
+        "%4 = OpTypeStruct %3\n"                // struct{ int32[] }
+        "%12 = OpTypePointer Uniform %4\n"      // struct{ int32[] }*
+        "%5 = OpVariable %12 Uniform\n"         // struct{ int32[] }* out
+        "%13 = OpConstant %9 0\n"               // int32(0)
+        "%14 = OpConstant %9 1\n"               // int32(1)
+        "%15 = OpConstant %9 2\n"               // int32(2)
+        "%16 = OpConstant %10 0\n"              // uint32(0)
+        "%17 = OpTypeVector %10 3\n"            // vec3<uint32>
+        "%18 = OpTypePointer Input %17\n"       // vec3<uint32>*
+        "%2 = OpVariable %18 Input\n"           // gl_GlobalInvocationId
+        "%19 = OpTypePointer Input %10\n"       // uint32*
+        "%6 = OpVariable %12 Uniform\n"         // struct{ int32[] }* in
+        "%20 = OpTypePointer Uniform %9\n"      // int32*
+        "%30 = OpTypeFunction %9 %9\n"          // int32(int32)
+        "%1 = OpFunction %7 None %8\n"          // -- Function begin --
+        "%21 = OpLabel\n"
+        "%22 = OpAccessChain %19 %2 %16\n"      // &gl_GlobalInvocationId.x
+        "%23 = OpLoad %10 %22\n"                // gl_GlobalInvocationId.x
+        "%24 = OpAccessChain %20 %6 %13 %23\n"  // &in.arr[gl_GlobalInvocationId.x]
+        "%25 = OpLoad %9 %24\n"                 // in.arr[gl_GlobalInvocationId.x]
+        "%26 = OpAccessChain %20 %5 %13 %23\n"  // &out.arr[gl_GlobalInvocationId.x]
+        "%27 = OpFunctionCall %9 %31 %25\n"     // f(in)
+        "%28 = OpFunctionCall %9 %31 %14\n"     // f(1)
+        "%29 = OpIAdd %9 %27 %28\n"
+        "OpStore %26 %29\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n"
+        "%31 = OpFunction %9 DontInline %30\n"  // -- Function f begin --
+        "%32 = OpFunctionParameter %9\n"        // x
+        "%33 = OpLabel\n"
+        "%34 = OpSMod %9 %32 %15\n"             // x % 2
+        "%35 = OpIEqual %11 %34 %13\n"          // (x % 2) == 0
+        "OpSelectionMerge %36 None\n"
+        "OpBranchConditional %35 %37 %36\n"
+        "%37 = OpLabel\n"
+        "%38 = OpIMul %9 %32 %15\n"             // x * 2
+        "OpReturnValue %38\n"
+        "%36 = OpLabel\n"
+        "%39 = OpIAdd %9 %32 %14\n"             // x + 1
+        "OpReturnValue %39\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	test(
+	    src.str(), [](uint32_t i) { return i; }, [](uint32_t i) { return ((i % 2) == 0 ? i * 2 : i + 1) + 2; });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, AtomicAddUniqueResults)
+{
+	// #version 450
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     int Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     int Data[];
+	// } Out;
+	// void main()
+	// {
+	//     if (gl_GlobalInvocationID.x % 3 != 0)
+	//     {
+	//         Out.Data[atomicAdd(In.Data[0], 1)] = 1;
+	//     }
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"               // void()
+        "%9 = OpTypeInt 32 1\n"                  // int32
+        "%10 = OpTypeInt 32 0\n"                 // uint32
+        "%11 = OpTypeBool\n"
+        "%3 = OpTypeRuntimeArray %9\n"           // int32[]
+        "%4 = OpTypeStruct %3\n"                 // struct{ int32[] }
+        "%12 = OpTypePointer Uniform %4\n"       // struct{ int32[] }*
+        "%5 = OpVariable %12 Uniform\n"          // struct{ int32[] }* out
+        "%13 = OpConstant %9 0\n"                // int32(0)
+        "%14 = OpConstant %9 1\n"                // int32(1)
+        "%15 = OpConstant %10 0\n"               // uint32(0)
+        "%16 = OpConstant %10 1\n"               // uint32(1), Device scope
+        "%17 = OpConstant %10 3\n"               // uint32(3)
+        "%18 = OpTypeVector %10 3\n"             // vec3<uint32>
+        "%19 = OpTypePointer Input %18\n"        // vec3<uint32>*
+        "%2 = OpVariable %19 Input\n"            // gl_GlobalInvocationId
+        "%20 = OpTypePointer Input %10\n"        // uint32*
+        "%6 = OpVariable %12 Uniform\n"          // struct{ int32[] }* in
+        "%21 = OpTypePointer Uniform %9\n"       // int32*
+        "%1 = OpFunction %7 None %8\n"           // -- Function begin --
+        "%22 = OpLabel\n"
+        "%23 = OpAccessChain %20 %2 %15\n"       // &gl_GlobalInvocationId.x
+        "%24 = OpLoad %10 %23\n"                 // gl_GlobalInvocationId.x
+        "%25 = OpUMod %10 %24 %17\n"             // gl_GlobalInvocationId.x % 3
+        "%26 = OpINotEqual %11 %25 %15\n"        // (gl_GlobalInvocationId.x % 3) != 0
+        "OpSelectionMerge %27 None\n"
+        "OpBranchConditional %26 %28 %27\n"
+        "%28 = OpLabel\n"
+        "%29 = OpAccessChain %21 %6 %13 %13\n"   // &in.arr[0]
+        "%30 = OpAtomicIAdd %9 %29 %16 %15 %14\n"  // atomicAdd(in.arr[0], 1)
+        "%31 = OpAccessChain %21 %5 %13 %30\n"   // &out.arr[atomicAdd(in.arr[0], 1)]
+        "OpStore %31 %14\n"
+        "OpBranch %27\n"
+        "%27 = OpLabel\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	// Each invocation which takes part must get a distinct result, so every slot
+	// below the number of participating invocations gets written exactly once.
+	const uint32_t numElements = static_cast<uint32_t>(GetParam().numElements);
+	const uint32_t count = numElements - (numElements + 2) / 3;
+
+	test(
+	    src.str(), [](uint32_t i) { return 0; }, [count](uint32_t i) { return (i < count) ? 1 : 0; });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, AtomicAddHistogramBins)
+{
+	// #version 450
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     int Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     int Data[];
+	// } Out;
+	// void main()
+	// {
+	//     uint bin = gl_GlobalInvocationID.x % 2;
+	//     Out.Data[2 * atomicAdd(In.Data[bin], 1) + int(bin)] = 1;
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"               // void()
+        "%9 = OpTypeInt 32 1\n"                  // int32
+        "%10 = OpTypeInt 32 0\n"                 // uint32
+        "%3 = OpTypeRuntimeArray %9\n"           // int32[]
+        "%4 = OpTypeStruct %3\n"                 // struct{ int32[] }
+        "%12 = OpTypePointer Uniform %4\n"       // struct{ int32[] }*
+        "%5 = OpVariable %12 Uniform\n"          // struct{ int32[] }* out
+        "%13 = OpConstant %9 0\n"                // int32(0)
+        "%14 = OpConstant %9 1\n"                // int32(1)
+        "%15 = OpConstant %10 0\n"               // uint32(0)
+        "%16 = OpConstant %10 1\n"               // uint32(1), Device scope
+        "%17 = OpConstant %10 2\n"               // uint32(2)
+        "%18 = OpTypeVector %10 3\n"             // vec3<uint32>
+        "%19 = OpTypePointer Input %18\n"        // vec3<uint32>*
+        "%2 = OpVariable %19 Input\n"            // gl_GlobalInvocationId
+        "%20 = OpTypePointer Input %10\n"        // uint32*
+        "%6 = OpVariable %12 Uniform\n"          // struct{ int32[] }* in
+        "%21 = OpTypePointer Uniform %9\n"       // int32*
+        "%1 = OpFunction %7 None %8\n"           // -- Function begin --
+        "%22 = OpLabel\n"
+        "%23 = OpAccessChain %20 %2 %15\n"       // &gl_GlobalInvocationId.x
+        "%24 = OpLoad %10 %23\n"                 // gl_GlobalInvocationId.x
+        "%25 = OpUMod %10 %24 %17\n"             // bin = gl_GlobalInvocationId.x % 2
+        "%26 = OpAccessChain %21 %6 %13 %25\n"   // &in.arr[bin]
+        "%27 = OpAtomicIAdd %9 %26 %16 %15 %14\n"  // atomicAdd(in.arr[bin], 1)
+        "%28 = OpBitcast %9 %25\n"               // int(bin)
+        "%29 = OpIAdd %9 %27 %27\n"              // 2 * atomicAdd(in.arr[bin], 1)
+        "%30 = OpIAdd %9 %29 %28\n"              // 2 * atomicAdd(in.arr[bin], 1) + int(bin)
+        "%31 = OpAccessChain %21 %5 %13 %30\n"   // &out.arr[2 * atomicAdd(in.arr[bin], 1) + int(bin)]
+        "OpStore %31 %14\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	// Invocations of each bin must get distinct results, so every slot gets written
+	// exactly once.
+	test(
+	    src.str(), [](uint32_t i) { return 0; }, [](uint32_t i) { return 1; });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, AtomicSharedAddressPartialMask)
+{
+	// #version 450
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     int Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     int Data[];
+	// } Out;
+	// void main()
+	// {
+	//     uint x = gl_GlobalInvocationID.x;
+	//     bool even = (x % 2) == 0;
+	//     uint index = x >> 16;  // Zero, but not known at compile time.
+	//     // Operands of the inactive lanes would change In.Data[index].
+	//     int minValue = even ? 200 : 0;
+	//     int maxValue = even ? 0 : 200;
+	//     int andValue = even ? -1 : 0;
+	//     int orValue = even ? 0 : -1;
+	//     int updateValue = even ? 150 : 1000;
+	//     int result = 0;
+	//     if (even)
+	//     {
+	//         result += (atomicMin(In.Data[index], minValue) == 100) ? 1 : 0;
+	//         result += (atomicMax(In.Data[index], maxValue) == 100) ? 1 : 0;
+	//         result += (atomicAnd(In.Data[index], andValue) == 100) ? 1 : 0;
+	//         result += (atomicOr(In.Data[index], orValue) == 100) ? 1 : 0;
+	//         int updated = atomicMax(In.Data[index + 1], updateValue);
+	//         result += (updated == 100 || updated == 150) ? 1 : 0;
+	//     }
+	//     Out.Data[x] = result;
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"               // void()
+        "%9 = OpTypeInt 32 1\n"                  // int32
+        "%10 = OpTypeInt 32 0\n"                 // uint32
+        "%11 = OpTypeBool\n"
+        "%3 = OpTypeRuntimeArray %9\n"           // int32[]
+        "%4 = OpTypeStruct %3\n"                 // struct{ int32[] }
+        "%12 = OpTypePointer Uniform %4\n"       // struct{ int32[] }*
+        "%5 = OpVariable %12 Uniform\n"          // struct{ int32[] }* out
+        "%13 = OpConstant %9 0\n"                // int32(0)
+        "%14 = OpConstant %9 1\n"                // int32(1)
+        "%15 = OpConstant %10 0\n"               // uint32(0)
+        "%16 = OpConstant %10 1\n"               // uint32(1), Device scope
+        "%17 = OpConstant %10 2\n"               // uint32(2)
+        "%18 = OpConstant %10 16\n"              // uint32(16)
+        "%19 = OpConstant %9 100\n"              // int32(100)
+        "%20 = OpConstant %9 150\n"              // int32(150)
+        "%21 = OpConstant %9 200\n"              // int32(200)
+        "%22 = OpConstant %9 1000\n"             // int32(1000)
+        "%23 = OpConstant %9 -1\n"               // int32(-1)
+        "%24 = OpTypeVector %10 3\n"             // vec3<uint32>
+        "%25 = OpTypePointer Input %24\n"        // vec3<uint32>*
+        "%2 = OpVariable %25 Input\n"            // gl_GlobalInvocationId
+        "%26 = OpTypePointer Input %10\n"        // uint32*
+        "%6 = OpVariable %12 Uniform\n"          // struct{ int32[] }* in
+        "%27 = OpTypePointer Uniform %9\n"       // int32*
+        "%1 = OpFunction %7 None %8\n"           // -- Function begin --
+        "%28 = OpLabel\n"
+        "%29 = OpAccessChain %26 %2 %15\n"       // &gl_GlobalInvocationId.x
+        "%30 = OpLoad %10 %29\n"                 // x
+        "%31 = OpUMod %10 %30 %17\n"             // x % 2
+        "%32 = OpIEqual %11 %31 %15\n"           // even
+        "%33 = OpShiftRightLogical %10 %30 %18\n"  // index
+        "%34 = OpIAdd %10 %33 %16\n"             // index + 1
+        "%35 = OpSelect %9 %32 %21 %13\n"        // minValue
+        "%36 = OpSelect %9 %32 %13 %21\n"        // maxValue
+        "%37 = OpSelect %9 %32 %23 %13\n"        // andValue
+        "%38 = OpSelect %9 %32 %13 %23\n"        // orValue
+        "%39 = OpSelect %9 %32 %20 %22\n"        // updateValue
+        "%40 = OpAccessChain %27 %5 %13 %30\n"   // &out.arr[x]
+        "OpSelectionMerge %41 None\n"
+        "OpBranchConditional %32 %42 %41\n"
+        "%42 = OpLabel\n"
+        "%43 = OpAccessChain %27 %6 %13 %33\n"   // &in.arr[index]
+        "%44 = OpAtomicSMin %9 %43 %16 %15 %35\n"  // atomicMin(in.arr[index], minValue)
+        "%45 = OpAtomicSMax %9 %43 %16 %15 %36\n"  // atomicMax(in.arr[index], maxValue)
+        "%46 = OpAtomicAnd %9 %43 %16 %15 %37\n"   // atomicAnd(in.arr[index], andValue)
+        "%47 = OpAtomicOr %9 %43 %16 %15 %38\n"    // atomicOr(in.arr[index], orValue)
+        "%48 = OpAccessChain %27 %6 %13 %34\n"   // &in.arr[index + 1]
+        "%49 = OpAtomicSMax %9 %48 %16 %15 %39\n"  // updated
+        "%50 = OpIEqual %11 %44 %19\n"
+        "%51 = OpIEqual %11 %45 %19\n"
+        "%52 = OpIEqual %11 %46 %19\n"
+        "%53 = OpIEqual %11 %47 %19\n"
+        "%54 = OpIEqual %11 %49 %19\n"
+        "%55 = OpIEqual %11 %49 %20\n"
+        "%56 = OpLogicalOr %11 %54 %55\n"
+        "%57 = OpSelect %9 %50 %14 %13\n"
+        "%58 = OpSelect %9 %51 %14 %13\n"
+        "%59 = OpSelect %9 %52 %14 %13\n"
+        "%60 = OpSelect %9 %53 %14 %13\n"
+        "%61 = OpSelect %9 %56 %14 %13\n"
+        "%62 = OpIAdd %9 %57 %58\n"
+        "%63 = OpIAdd %9 %62 %59\n"
+        "%64 = OpIAdd %9 %63 %60\n"
+        "%65 = OpIAdd %9 %64 %61\n"
+        "OpBranch %41\n"
+        "%41 = OpLabel\n"
+        "%66 = OpPhi %9 %13 %28 %65 %42\n"       // result
+        "OpStore %40 %66\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	// None of the operations of the even invocations change In.Data[0], so they all
+	// observe its initial value. In.Data[1] is only ever raised to 150.
+	test(
+	    src.str(), [](uint32_t i) { return (i <= 1) ? 100 : 0; }, [](uint32_t i) { return ((i % 2) == 0) ? 5 : 0; });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, WorkgroupAtomics)
+{
+	// #version 450
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     int Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     int Data[];
+	// } Out;
+	// shared int values[32];
+	// shared int seen[32];
+	// shared int counter;
+	// void main()
+	// {
+	//     uint id = gl_LocalInvocationID.x;
+	//     uint size = gl_WorkGroupSize.x;
+	//     values[id] = 0;
+	//     seen[id] = 0;
+	//     counter = 0;
+	//     barrier();
+	//     // Sequential offsets
+	//     int a = atomicAdd(values[id], int(id) + 1);
+	//     barrier();
+	//     // Distinct offsets
+	//     int b = atomicXor(values[size - 1 - id], 0x100);
+	//     barrier();
+	//     // Colliding offsets
+	//     int c = atomicAdd(values[id >> 1], 0x10000);
+	//     // Same offset
+	//     int d = atomicAdd(counter, 1);
+	//     seen[d & 31] = 1;
+	//     barrier();
+	//     int base = int(id >> 1) + 1 + 0x100;
+	//     int collisions = ((id | 1) < size) ? 2 : 1;
+	//     int result = 0;
+	//     result += (a == 0) ? 1 : 0;
+	//     result += (b == int(size - id)) ? 2 : 0;
+	//     result += ((c & 0xFFFF) == base && (c >> 16) <= 1) ? 4 : 0;
+	//     result += (values[id >> 1] == base + 0x10000 * collisions) ? 8 : 0;
+	//     result += (d < int(size)) ? 16 : 0;
+	//     result += (seen[id] == 1) ? 32 : 0;
+	//     result += (counter == int(size)) ? 64 : 0;
+	//     Out.Data[gl_GlobalInvocationID.x] = result;
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2 %34\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %34 BuiltIn LocalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"               // void()
+        "%9 = OpTypeInt 32 1\n"                  // int32
+        "%10 = OpTypeInt 32 0\n"                 // uint32
+        "%11 = OpTypeBool\n"
+        "%3 = OpTypeRuntimeArray %9\n"           // int32[]
+        "%4 = OpTypeStruct %3\n"                 // struct{ int32[] }
+        "%12 = OpTypePointer Uniform %4\n"       // struct{ int32[] }*
+        "%5 = OpVariable %12 Uniform\n"          // struct{ int32[] }* out
+        "%13 = OpConstant %9 0\n"                // int32(0)
+        "%14 = OpConstant %9 1\n"                // int32(1)
+        "%15 = OpConstant %10 0\n"               // uint32(0)
+        "%16 = OpConstant %10 1\n"               // uint32(1)
+        "%17 = OpConstant %10 2\n"               // uint32(2), Workgroup scope
+        "%18 = OpConstant %10 32\n"              // uint32(32)
+        "%19 = OpConstant %10 264\n"             // uint32(264), AcquireRelease | WorkgroupMemory
+        "%20 = OpConstant %9 256\n"              // int32(0x100)
+        "%21 = OpConstant %9 65536\n"            // int32(0x10000)
+        "%22 = OpConstant %9 16\n"               // int32(16)
+        "%23 = OpConstant %9 31\n"               // int32(31)
+        "%24 = OpConstant %9 65535\n"            // int32(0xFFFF)
+        "%25 = OpConstant %9 2\n"                // int32(2)
+        "%26 = OpConstant %9 4\n"                // int32(4)
+        "%27 = OpConstant %9 8\n"                // int32(8)
+        "%28 = OpConstant %9 32\n"               // int32(32)
+        "%29 = OpConstant %9 64\n"               // int32(64)
+        "%30 = OpConstant %10 " << GetParam().localSizeX << "\n" <<  // uint32(size)
+        "%31 = OpConstant %9 " << GetParam().localSizeX << "\n" <<   // int32(size)
+        "%32 = OpTypeVector %10 3\n"             // vec3<uint32>
+        "%33 = OpTypePointer Input %32\n"        // vec3<uint32>*
+        "%2 = OpVariable %33 Input\n"            // gl_GlobalInvocationId
+        "%34 = OpVariable %33 Input\n"           // gl_LocalInvocationId
+        "%35 = OpTypePointer Input %10\n"        // uint32*
+        "%6 = OpVariable %12 Uniform\n"          // struct{ int32[] }* in
+        "%36 = OpTypePointer Uniform %9\n"       // int32*
+        "%37 = OpTypeArray %9 %18\n"             // int32[32]
+        "%38 = OpTypePointer Workgroup %37\n"    // int32[32]*
+        "%39 = OpTypePointer Workgroup %9\n"     // int32*
+        "%40 = OpVariable %38 Workgroup\n"       // values
+        "%41 = OpVariable %38 Workgroup\n"       // seen
+        "%42 = OpVariable %39 Workgroup\n"       // counter
+        "%1 = OpFunction %7 None %8\n"           // -- Function begin --
+        "%50 = OpLabel\n"
+        "%51 = OpAccessChain %35 %2 %15\n"       // &gl_GlobalInvocationId.x
+        "%52 = OpLoad %10 %51\n"                 // gl_GlobalInvocationId.x
+        "%53 = OpAccessChain %35 %34 %15\n"      // &gl_LocalInvocationId.x
+        "%54 = OpLoad %10 %53\n"                 // id
+        "%55 = OpBitcast %9 %54\n"               // int(id)
+        "%56 = OpAccessChain %39 %40 %54\n"      // &values[id]
+        "%57 = OpAccessChain %39 %41 %54\n"      // &seen[id]
+        "OpStore %56 %13\n"
+        "OpStore %57 %13\n"
+        "OpStore %42 %13\n"
+        "OpControlBarrier %17 %17 %19\n"
+        "%58 = OpIAdd %9 %55 %14\n"              // int(id) + 1
+        "%59 = OpAtomicIAdd %9 %56 %17 %15 %58\n"  // a
+        "OpControlBarrier %17 %17 %19\n"
+        "%60 = OpISub %10 %30 %16\n"             // size - 1
+        "%61 = OpISub %10 %60 %54\n"             // size - 1 - id
+        "%62 = OpAccessChain %39 %40 %61\n"      // &values[size - 1 - id]
+        "%63 = OpAtomicXor %9 %62 %17 %15 %20\n"   // b
+        "OpControlBarrier %17 %17 %19\n"
+        "%64 = OpShiftRightLogical %10 %54 %16\n"  // id >> 1
+        "%65 = OpAccessChain %39 %40 %64\n"      // &values[id >> 1]
+        "%66 = OpAtomicIAdd %9 %65 %17 %15 %21\n"  // c
+        "%67 = OpAtomicIIncrement %9 %42 %17 %15\n"  // d
+        "%68 = OpBitwiseAnd %9 %67 %23\n"        // d & 31
+        "%69 = OpAccessChain %39 %41 %68\n"      // &seen[d & 31]
+        "OpStore %69 %14\n"
+        "OpControlBarrier %17 %17 %19\n"
+        "%70 = OpLoad %9 %65\n"                  // values[id >> 1]
+        "%71 = OpLoad %9 %57\n"                  // seen[id]
+        "%72 = OpLoad %9 %42\n"                  // counter
+        "%73 = OpIEqual %11 %59 %13\n"           // a == 0
+        "%74 = OpISub %9 %31 %55\n"              // int(size - id)
+        "%75 = OpIEqual %11 %63 %74\n"           // b == int(size - id)
+        "%76 = OpBitcast %9 %64\n"               // int(id >> 1)
+        "%77 = OpIAdd %9 %76 %14\n"
+        "%78 = OpIAdd %9 %77 %20\n"              // base
+        "%79 = OpBitwiseAnd %9 %66 %24\n"        // c & 0xFFFF
+        "%80 = OpIEqual %11 %79 %78\n"
+        "%81 = OpShiftRightArithmetic %9 %66 %22\n"  // c >> 16
+        "%82 = OpSLessThanEqual %11 %81 %14\n"
+        "%83 = OpLogicalAnd %11 %80 %82\n"
+        "%84 = OpBitwiseOr %10 %54 %16\n"        // id | 1
+        "%85 = OpULessThan %11 %84 %30\n"
+        "%86 = OpSelect %9 %85 %25 %14\n"        // collisions
+        "%87 = OpIMul %9 %21 %86\n"
+        "%88 = OpIAdd %9 %78 %87\n"
+        "%89 = OpIEqual %11 %70 %88\n"
+        "%90 = OpSLessThan %11 %67 %31\n"        // d < int(size)
+        "%91 = OpIEqual %11 %71 %14\n"           // seen[id] == 1
+        "%92 = OpIEqual %11 %72 %31\n"           // counter == int(size)
+        "%93 = OpSelect %9 %73 %14 %13\n"
+        "%94 = OpSelect %9 %75 %25 %13\n"
+        "%95 = OpSelect %9 %83 %26 %13\n"
+        "%96 = OpSelect %9 %89 %27 %13\n"
+        "%97 = OpSelect %9 %90 %22 %13\n"
+        "%98 = OpSelect %9 %91 %28 %13\n"
+        "%99 = OpSelect %9 %92 %29 %13\n"
+        "%100 = OpIAdd %9 %93 %94\n"
+        "%101 = OpIAdd %9 %100 %95\n"
+        "%102 = OpIAdd %9 %101 %96\n"
+        "%103 = OpIAdd %9 %102 %97\n"
+        "%104 = OpIAdd %9 %103 %98\n"
+        "%105 = OpIAdd %9 %104 %99\n"            // result
+        "%106 = OpAccessChain %36 %5 %13 %52\n"  // &out.arr[gl_GlobalInvocationId.x]
+        "OpStore %106 %105\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	test(
+	    src.str(), [](uint32_t i) { return 0; }, [](uint32_t i) { return 127; });
+}
+
+TEST_P(SwiftShaderVulkanBufferToBufferComputeTest, WorkgroupAtomicCompareExchange)
+{
+	// #version 450
+	// layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+	// layout(binding = 0, std430) buffer InBuffer
+	// {
+	//     int Data[];
+	// } In;
+	// layout(binding = 1, std430) buffer OutBuffer
+	// {
+	//     int Data[];
+	// } Out;
+	// shared int owner;
+	// void main()
+	// {
+	//     int id = int(gl_LocalInvocationID.x);
+	//     owner = -1;
+	//     barrier();
+	//     int previous = atomicCompSwap(owner, -1, id);
+	//     barrier();
+	//     int result = 0;
+	//     result += ((previous == -1) == (owner == id)) ? 1 : 0;
+	//     result += (previous == -1 || previous == owner) ? 2 : 0;
+	//     Out.Data[gl_GlobalInvocationID.x] = result;
+	// }
+	std::stringstream src;
+	// clang-format off
+    src <<
+        "OpCapability Shader\n"
+        "OpMemoryModel Logical GLSL450\n"
+        "OpEntryPoint GLCompute %1 \"main\" %2 %34\n"
+        "OpExecutionMode %1 LocalSize " <<
+        GetParam().localSizeX << " " <<
+        GetParam().localSizeY << " " <<
+        GetParam().localSizeZ << "\n" <<
+        "OpDecorate %3 ArrayStride 4\n"
+        "OpMemberDecorate %4 0 Offset 0\n"
+        "OpDecorate %4 BufferBlock\n"
+        "OpDecorate %5 DescriptorSet 0\n"
+        "OpDecorate %5 Binding 1\n"
+        "OpDecorate %2 BuiltIn GlobalInvocationId\n"
+        "OpDecorate %34 BuiltIn LocalInvocationId\n"
+        "OpDecorate %6 DescriptorSet 0\n"
+        "OpDecorate %6 Binding 0\n"
+        "%7 = OpTypeVoid\n"
+        "%8 = OpTypeFunction %7\n"               // void()
+        "%9 = OpTypeInt 32 1\n"                  // int32
+        "%10 = OpTypeInt 32 0\n"                 // uint32
+        "%11 = OpTypeBool\n"
+        "%3 = OpTypeRuntimeArray %9\n"           // int32[]
+        "%4 = OpTypeStruct %3\n"                 // struct{ int32[] }
+        "%12 = OpTypePointer Uniform %4\n"       // struct{ int32[] }*
+        "%5 = OpVariable %12 Uniform\n"          // struct{ int32[] }* out
+        "%13 = OpConstant %9 0\n"                // int32(0)
+        "%14 = OpConstant %9 1\n"                // int32(1)
+        "%15 = OpConstant %10 0\n"               // uint32(0)
+        "%17 = OpConstant %10 2\n"               // uint32(2), Workgroup scope
+        "%19 = OpConstant %10 264\n"             // uint32(264), AcquireRelease | WorkgroupMemory
+        "%20 = OpConstant %9 -1\n"               // int32(-1)
+        "%25 = OpConstant %9 2\n"                // int32(2)
+        "%32 = OpTypeVector %10 3\n"             // vec3<uint32>
+        "%33 = OpTypePointer Input %32\n"        // vec3<uint32>*
+        "%2 = OpVariable %33 Input\n"            // gl_GlobalInvocationId
+        "%34 = OpVariable %33 Input\n"           // gl_LocalInvocationId
+        "%35 = OpTypePointer Input %10\n"        // uint32*
+        "%6 = OpVariable %12 Uniform\n"          // struct{ int32[] }* in
+        "%36 = OpTypePointer Uniform %9\n"       // int32*
+        "%39 = OpTypePointer Workgroup %9\n"     // int32*
+        "%42 = OpVariable %39 Workgroup\n"       // owner
+        "%1 = OpFunction %7 None %8\n"           // -- Function begin --
+        "%50 = OpLabel\n"
+        "%51 = OpAccessChain %35 %2 %15\n"       // &gl_GlobalInvocationId.x
+        "%52 = OpLoad %10 %51\n"                 // gl_GlobalInvocationId.x
+        "%53 = OpAccessChain %35 %34 %15\n"      // &gl_LocalInvocationId.x
+        "%54 = OpLoad %10 %53\n"                 // gl_LocalInvocationId.x
+        "%55 = OpBitcast %9 %54\n"               // id
+        "OpStore %42 %20\n"
+        "OpControlBarrier %17 %17 %19\n"
+        "%56 = OpAtomicCompareExchange %9 %42 %17 %15 %15 %55 %20\n"  // previous
+        "OpControlBarrier %17 %17 %19\n"
+        "%57 = OpLoad %9 %42\n"                  // owner
+        "%58 = OpIEqual %11 %56 %20\n"           // previous == -1
+        "%59 = OpIEqual %11 %57 %55\n"           // owner == id
+        "%60 = OpLogicalEqual %11 %58 %59\n"
+        "%61 = OpIEqual %11 %56 %57\n"           // previous == owner
+        "%62 = OpLogicalOr %11 %58 %61\n"
+        "%63 = OpSelect %9 %60 %14 %13\n"
+        "%64 = OpSelect %9 %62 %25 %13\n"
+        "%65 = OpIAdd %9 %63 %64\n"              // result
+        "%66 = OpAccessChain %36 %5 %13 %52\n"   // &out.arr[gl_GlobalInvocationId.x]
+        "OpStore %66 %65\n"
+        "OpReturn\n"
+        "OpFunctionEnd\n";
+	// clang-format on
+
+	// Exactly one invocation of each workgroup swaps in its ID, and the others
+	// observe it.
+	test(
+	    src.str(), [](uint32_t i) { return 0; }, [](uint32_t i) { return 3; });
+}
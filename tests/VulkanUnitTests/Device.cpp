@@ -147,13 +147,21 @@ VkResult Device::GetPhysicalDevices(
 VkResult Device::CreateStorageBuffer(
     VkDeviceMemory memory, VkDeviceSize size,
     VkDeviceSize offset, VkBuffer *out) const
+{
+	return CreateBuffer(memory, size, offset, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, out);
+}
+
+VkResult Device::CreateBuffer(
+    VkDeviceMemory memory, VkDeviceSize size,
+    VkDeviceSize offset, VkBufferUsageFlags usage,
+    VkBuffer *out) const
 {
 	const VkBufferCreateInfo info = {
 		VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,  // sType
 		nullptr,                               // pNext
 		0,                                     // flags
 		size,                                  // size
-		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,    // usage
+		usage,                                 // usage
 		VK_SHARING_MODE_EXCLUSIVE,             // sharingMode
 		0,                                     // queueFamilyIndexCount
 		nullptr,                               // pQueueFamilyIndices
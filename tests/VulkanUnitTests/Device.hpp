@@ -40,7 +40,13 @@ public:
 	// IsValid returns true if the Device is initialized and can be used.
 	bool IsValid() const;
 
-	// CreateBuffer creates a new buffer with the
+	// CreateBuffer creates a new buffer with the given usage, and
+	// VK_SHARING_MODE_EXCLUSIVE sharing mode.
+	VkResult CreateBuffer(VkDeviceMemory memory, VkDeviceSize size,
+	                      VkDeviceSize offset, VkBufferUsageFlags usage,
+	                      VkBuffer *out) const;
+
+	// CreateStorageBuffer creates a new buffer with the
 	// VK_BUFFER_USAGE_STORAGE_BUFFER_BIT usage, and
 	// VK_SHARING_MODE_EXCLUSIVE sharing mode.
 	VkResult CreateStorageBuffer(VkDeviceMemory memory, VkDeviceSize size,